@@ -4,131 +4,51 @@
  *
  * Este archivo contiene las funciones para determinar la posición absoluta
  * del jugador en el campo utilizando triangulación con puntos de referencia
- * conocidos (flags). Implementa algoritmos de localización por trilateración.
+ * conocidos (flags). Ajusta la pose por mínimos cuadrados ponderados con todos
+ * los flags visibles.
  */
 
 #include "AbsPos.h"
+#include "balon.h"
+#include "odometria.h"
 #include "structs.h"
 #include <MinimalSocket/udp/UdpSocket.h>
 #include "utilities.h"
 #include <iostream>
 
 /**
- * @brief Inicializa el vector de flags con las coordenadas absolutas conocidas
+ * @brief Inicializa las medidas de los flags a partir de la tabla constante
  *
- * Crea y configura todos los puntos de referencia estáticos del campo con
- * sus coordenadas absolutas predefinidas. El campo está representado como
- * un sistema de coordenadas de 120x80 unidades.
+ * Copia los puntos de referencia de TABLA_FLAGS (coordenadas absolutas y
+ * medidas a 999.0) y deja vacía la lista de flags visibles.
  *
- * @param flags Referencia al vector de shared_ptr<knownFlags> a inicializar
- *
- * @note Coordenadas del campo: X: 0-120 (ancho), Y: 0-80 (alto)
- * @note Centro del campo: (60, 40)
+ * @param flags Flags del agente a inicializar
  */
-void inicializacion_flags(vector<shared_ptr<knownFlags>> &flags)
+void inicializacion_flags(FlagsCampo &flags)
 {
-    // ======================================================
-    // PUNTOS CENTRALES Y ESQUINAS PRINCIPALES
-    // ======================================================
-    flags.push_back(make_shared<knownFlags>("(f c)", 60, 40, 999.0, 999.0));      // centro del campo
-    flags.push_back(make_shared<knownFlags>("(f l t)", 8, 74, 999.0, 999.0));     // esquina superior izquierda
-    flags.push_back(make_shared<knownFlags>("(f l b)", 8, 6, 999.0, 999.0));      // esquina inferior izquierda
-    flags.push_back(make_shared<knownFlags>("(f r t)", 112, 74, 999.0, 999.0));   // esquina superior derecha
-    flags.push_back(make_shared<knownFlags>("(f r b)", 112, 6, 999.0, 999.0));    // esquina inferior derecha
-
-    // ======================================================
-    // PUNTOS DEL ÁREA PENAL
-    // ======================================================
-    flags.push_back(make_shared<knownFlags>("(f p l t)", 24, 60, 999.0, 999.0));  // área superior izquierda
-    flags.push_back(make_shared<knownFlags>("(f p l c)", 24, 40, 999.0, 999.0));  // área central izquierda
-    flags.push_back(make_shared<knownFlags>("(f p l b)", 24, 20, 999.0, 999.0));  // área inferior izquierda
-    flags.push_back(make_shared<knownFlags>("(f p r t)", 96, 60, 999.0, 999.0));  // área superior derecha
-    flags.push_back(make_shared<knownFlags>("(f p r c)", 96, 40, 999.0, 999.0));  // área central derecha
-    flags.push_back(make_shared<knownFlags>("(f p r b)", 96, 20, 999.0, 999.0));  // área inferior derecha
-
-    // ======================================================
-    // PALOS DE PORTERÍA
-    // ======================================================
-    flags.push_back(make_shared<knownFlags>("(f g l t)", 8, 47, 999.0, 999.0));   // palo superior izquierdo
-    flags.push_back(make_shared<knownFlags>("(f g l b)", 8, 33, 999.0, 999.0));   // palo inferior izquierdo
-    flags.push_back(make_shared<knownFlags>("(f g r t)", 112, 47, 999.0, 999.0)); // palo superior derecho
-    flags.push_back(make_shared<knownFlags>("(f g r b)", 112, 33, 999.0, 999.0)); // palo inferior derecho
-
-    // ======================================================
-    // BANDA SUPERIOR (FUERA DEL CAMPO)
-    // ======================================================
-    flags.push_back(make_shared<knownFlags>("(f t l 10)", 50, 80, 999.0, 999.0)); // banda superior izquierda (-10)
-    flags.push_back(make_shared<knownFlags>("(f t l 20)", 40, 80, 999.0, 999.0)); // banda superior izquierda (-20)
-    flags.push_back(make_shared<knownFlags>("(f t l 30)", 30, 80, 999.0, 999.0)); // banda superior izquierda (-30)
-    flags.push_back(make_shared<knownFlags>("(f t l 50)", 10, 80, 999.0, 999.0)); // banda superior izquierda (-50)
-    flags.push_back(make_shared<knownFlags>("(f t 0)", 60, 80, 999.0, 999.0));    // centro banda superior
-    flags.push_back(make_shared<knownFlags>("(f t r 10)", 70, 80, 999.0, 999.0)); // banda superior derecha (+10)
-    flags.push_back(make_shared<knownFlags>("(f t r 20)", 80, 80, 999.0, 999.0)); // banda superior derecha (+20)
-    flags.push_back(make_shared<knownFlags>("(f t r 30)", 90, 80, 999.0, 999.0)); // banda superior derecha (+30)
-    flags.push_back(make_shared<knownFlags>("(f t r 40)", 100, 80, 999.0, 999.0)); // banda superior derecha (+40)
-    flags.push_back(make_shared<knownFlags>("(f t r 50)", 110, 80, 999.0, 999.0)); // banda superior derecha (+50)
-
-    // ======================================================
-    // BANDA INFERIOR (FUERA DEL CAMPO)
-    // ======================================================
-    flags.push_back(make_shared<knownFlags>("(f b l 10)", 50, 0, 999.0, 999.0));   // banda inferior izquierda (-10)
-    flags.push_back(make_shared<knownFlags>("(f b l 20)", 40, 0, 999.0, 999.0));   // banda inferior izquierda (-20)
-    flags.push_back(make_shared<knownFlags>("(f b l 30)", 30, 0, 999.0, 999.0));   // banda inferior izquierda (-30)
-    flags.push_back(make_shared<knownFlags>("(f b l 40)", 20, 0, 999.0, 999.0));   // banda inferior izquierda (-40)
-    flags.push_back(make_shared<knownFlags>("(f b l 50)", 10, 0, 999.0, 999.0));   // banda inferior izquierda (-50)
-    flags.push_back(make_shared<knownFlags>("(f b 0)", 60, 0, 999.0, 999.0));      // centro banda inferior
-    flags.push_back(make_shared<knownFlags>("(f b r 10)", 70, 0, 999.0, 999.0));   // banda inferior derecha (+10)
-    flags.push_back(make_shared<knownFlags>("(f b r 20)", 80, 0, 999.0, 999.0));   // banda inferior derecha (+20)
-    flags.push_back(make_shared<knownFlags>("(f b r 30)", 90, 0, 999.0, 999.0));   // banda inferior derecha (+30)
-    flags.push_back(make_shared<knownFlags>("(f b r 40)", 100, 0, 999.0, 999.0));  // banda inferior derecha (+40)
-    flags.push_back(make_shared<knownFlags>("(f b r 50)", 110, 0, 999.0, 999.0));  // banda inferior derecha (+50)
-
-    // ======================================================
-    // LÍNEA DE FONDO IZQUIERDA (FUERA DEL CAMPO)
-    // ======================================================
-    flags.push_back(make_shared<knownFlags>("(f l t 10)", 0, 50, 999.0, 999.0));   // fondo izquierdo superior (-10)
-    flags.push_back(make_shared<knownFlags>("(f l t 20)", 0, 60, 999.0, 999.0));   // fondo izquierdo superior (-20)
-    flags.push_back(make_shared<knownFlags>("(f l t 30)", 0, 70, 999.0, 999.0));   // fondo izquierdo superior (-30)
-    flags.push_back(make_shared<knownFlags>("(f l b 10)", 0, 30, 999.0, 999.0));   // fondo izquierdo inferior (-10)
-    flags.push_back(make_shared<knownFlags>("(f l b 20)", 0, 20, 999.0, 999.0));   // fondo izquierdo inferior (-20)
-    flags.push_back(make_shared<knownFlags>("(f l b 30)", 0, 10, 999.0, 999.0));   // fondo izquierdo inferior (-30)
-
-    // ======================================================
-    // LÍNEA DE FONDO DERECHA (FUERA DEL CAMPO)
-    // ======================================================
-    flags.push_back(make_shared<knownFlags>("(f r t 10)", 120, 50, 999.0, 999.0)); // fondo derecho superior (-10)
-    flags.push_back(make_shared<knownFlags>("(f r t 20)", 120, 60, 999.0, 999.0)); // fondo derecho superior (-20)
-    flags.push_back(make_shared<knownFlags>("(f r t 30)", 120, 70, 999.0, 999.0)); // fondo derecho superior (-30)
-    flags.push_back(make_shared<knownFlags>("(f r b 10)", 120, 30, 999.0, 999.0)); // fondo derecho inferior (-10)
-    flags.push_back(make_shared<knownFlags>("(f r b 20)", 120, 20, 999.0, 999.0)); // fondo derecho inferior (-20)
-    flags.push_back(make_shared<knownFlags>("(f r b 30)", 120, 10, 999.0, 999.0)); // fondo derecho inferior (-30)
-
-    // ======================================================
-    // PUNTOS CENTRALES ADICIONALES
-    // ======================================================
-    flags.push_back(make_shared<knownFlags>("(f c t)", 60, 74, 999.0, 999.0));    // centro banda superior
-    flags.push_back(make_shared<knownFlags>("(f c b)", 60, 6, 999.0, 999.0));     // centro banda inferior
-    flags.push_back(make_shared<knownFlags>("(f c r)", 120, 40, 999.0, 999.0));   // centro línea de fondo derecha
-    flags.push_back(make_shared<knownFlags>("(f c l)", 0, 40, 999.0, 999.0));     // centro línea de fondo izquierda
+    for (int i = 0; i < NUM_FLAGS; i++)
+        flags.flags[i] = TABLA_FLAGS[i];
+    flags.num_visibles = 0;
 }
 
 /**
- * @brief Muestra en consola la información de todos los flags
+ * @brief Muestra en consola la información de los flags visibles
  *
- * Función de depuración que imprime el estado actual de todos los flags,
+ * Función de depuración que imprime los flags del último "see",
  * incluyendo nombre, coordenadas absolutas y medidas relativas actuales.
  *
- * @param flag Referencia al vector de flags a imprimir
+ * @param flag Flags a imprimir, en el orden del mensaje
  */
-void imprimir_matriz(vector<shared_ptr<knownFlags>> &flag)
+void imprimir_matriz(FlagsCampo const &flag)
 {
-    for (auto const &f : flag)
+    for (int k = 0; k < flag.num_visibles; k++)
     {
-        cout << "Nombre: " << f->name;
-        cout << " Distancia: " << f->distancia;
-        cout << " Direccion: " << f->direccion;
-        cout << " X_absoluta: " << f->x;
-        cout << " Y_absoluta: " << f->y;
+        knownFlags const &f = flag.visible(k);
+        cout << "Nombre: " << f.name;
+        cout << " Distancia: " << f.distancia;
+        cout << " Direccion: " << f.direccion;
+        cout << " X_absoluta: " << f.x;
+        cout << " Y_absoluta: " << f.y;
         cout << endl;
     }
 }
@@ -140,235 +60,413 @@ void imprimir_matriz(vector<shared_ptr<knownFlags>> &flag)
  * flags visibles y actualiza sus distancias y direcciones relativas.
  * Flags no visibles se marcan con 999.0 (valor sentinela).
  *
- * @param mensaje Cadena del mensaje "see" recibido del servidor
- * @param flags Referencia al vector de flags a actualizar
+ * @param observacion Objetos del mensaje "see" ya decodificados
+ * @param flags Flags del agente a actualizar (medidas y lista de visibles)
  *
  * @note Formato mensaje: "(see ((f c) 15.2 30.5) ((f l t) 20.1 45.3) ...)"
  */
-void crear_matriz_valores_absolutos(string const &mensaje, vector<shared_ptr<knownFlags>> &flags)
+void crear_matriz_valores_absolutos(ObservacionSee const &observacion, FlagsCampo &flags)
 {
-    if (mensaje.find("see") == -1)
+    if (!observacion.valida)
         return;
-    vector<string> vector_mensaje = separate_string(mensaje);                // see ((  f l c (2132)) )
-    vector<string> vector_mensaje_2 = separate_string(vector_mensaje.at(0)); // {1} see {2} (f c l)(12) (23) .... {23} ((b) 12 23.3)
-    for (auto const &f : flags)
+
+    // Solo se borran los flags del "see" anterior: el resto ya está a 999.0
+    for (int k = 0; k < flags.num_visibles; k++)
     {
-        if (mensaje.find(f->name) == -1)
-        {
-            f->direccion = 999.0;
-            f->distancia = 999.0;
-        }
-        else
-        {
-            for (auto const &v : vector_mensaje_2)
-            {
-                if (v.find(f->name) != -1)
-                {
-                    vector<string> vector_balon;
-                    string nueva_linea = vector_separar_string(v);
-                    vector_balon = separate_string_separator(nueva_linea, ' ');
+        knownFlags &f = flags.flags[flags.visibles[k]];
+        f.direccion = DESCONOCIDO;
+        f.distancia = DESCONOCIDO;
+    }
+    flags.num_visibles = 0;
 
-                    // EJEMPLO ((b) 12 23.3)
-                    f->distancia = stod(vector_balon.at(0)); // 12
-                    f->direccion = stod(vector_balon.at(1)); // 23.3
-                }
-            }
-            // inicializacion_flags << "Algo ha fallado" << endl;
-        }
+    // El decodificador ya resolvió el índice de cada flag con el hash perfecto
+    for (auto const &objeto : observacion.objetos)
+    {
+        if (objeto.flag < 0 || objeto.num_valores < 2)
+            continue;
+        // EJEMPLO ((f c) 12 23.3)
+        knownFlags &f = flags.flags[objeto.flag];
+        if (f.distancia == DESCONOCIDO)
+            flags.visibles[flags.num_visibles++] = static_cast<uint8_t>(objeto.flag);
+        f.distancia = objeto.distancia; // 12
+        f.direccion = objeto.direccion; // 23.3
     }
-    sort(flags.begin(), flags.end(), [](const shared_ptr<knownFlags> &f1, const shared_ptr<knownFlags> &f2)
-         { return f1->distancia < f2->distancia; });
 }
 
+// ======================================================
+// MODELO DE ERROR DE LAS MEDIDAS
+// ======================================================
+/// Paso logarítmico con el que el servidor cuantiza la distancia a un flag (quantize_step_l)
+constexpr double CUANTIZACION_FLAGS = 0.01;
+/// El servidor redondea las distancias a décimas
+constexpr double PASO_DISTANCIA = 0.1;
+/// Las direcciones llegan en grados enteros
+constexpr double PASO_DIRECCION = M_PI / 180;
+/// Error de las coordenadas de la tabla (redondeadas al marco de 120x80) frente al campo real
+constexpr double ERROR_TABLA_FLAGS = 0.25;
+
 /**
- * @brief Calcula la posición absoluta del jugador mediante trilateración
- *
- * Utiliza tres flags visibles para triangular la posición del jugador en
- * coordenadas absolutas del campo. Implementa algoritmo de trilateración
- * geométrica con manejo de casos especiales (colinealidad, errores).
+ * @brief Varianza de la distancia medida a un flag
  *
- * @param flags Vector de flags visibles ordenados por distancia
- * @param datos Estructura Game_data donde se almacenará la posición calculada
- *
- * @algorithm Basado en trilateración con 3 puntos y solución de triángulos
- * @note Usa los 3 flags más cercanos para mayor precisión
+ * Un error uniforme de ancho w tiene varianza w²/12; el ancho del escalón
+ * logarítmico crece con la distancia (d·q).
  */
-void relative2Abssolute(vector<shared_ptr<knownFlags>> &flags, Game_data &datos)
+static double varianza_distancia(double d)
 {
-    // ======================================================
-    // EXTRACCIÓN DE DATOS DE LOS 3 FLAGS MÁS CERCANOS
-    // ======================================================
-    float theta1 = -flags.at(0)->direccion;  // Ángulo al flag 1 (convertido a sistema matemático)
-    float d1 = flags.at(0)->distancia;       // Distancia al flag 1
-    float x1 = flags.at(0)->x;               // Coordenada X absoluta del flag 1
-    float y1 = flags.at(0)->y;               // Coordenada Y absoluta del flag 1
+    double escalon = d * CUANTIZACION_FLAGS;
+    return (escalon * escalon + PASO_DISTANCIA * PASO_DISTANCIA) / 12 + ERROR_TABLA_FLAGS * ERROR_TABLA_FLAGS;
+}
+
+/**
+ * @brief Varianza (rad²) de la dirección medida a un flag a distancia d
+ */
+static double varianza_direccion(double d)
+{
+    double error_tabla = ERROR_TABLA_FLAGS / max(d, 1.0);
+    return PASO_DIRECCION * PASO_DIRECCION / 12 + error_tabla * error_tabla;
+}
 
-    float theta2 = -flags.at(1)->direccion;  // Ángulo al flag 2
-    float d2 = flags.at(1)->distancia;       // Distancia al flag 2
-    float x2 = flags.at(1)->x;               // Coordenada X absoluta del flag 2
-    float y2 = flags.at(1)->y;               // Coordenada Y absoluta del flag 2
+/**
+ * @brief Medida de un flag preparada para el ajuste
+ */
+struct MedidaFlag
+{
+    double x, y;        ///< Posición absoluta del flag
+    double d;           ///< Distancia medida
+    double ux, uy;      ///< Dirección medida como vector unitario en el marco de la vista
+    double peso_d;      ///< Inverso de la varianza de la distancia
+    double peso_a;      ///< Inverso de la varianza de la dirección
+};
 
-    float theta3 = -flags.at(2)->direccion;  // Ángulo al flag 3
-    float d3 = flags.at(2)->distancia;       // Distancia al flag 3
-    float x3 = flags.at(2)->x;               // Coordenada X absoluta del flag 3
-    float y3 = flags.at(2)->y;               // Coordenada Y absoluta del flag 3
+/**
+ * @brief Navegación a estima: sin corrección se conserva la pose predicha por la odometría
+ */
+static EstadoLocalizacion sin_correccion(Game_data &datos, int num_flags)
+{
+    return {false, num_flags, 0, datos.jugador.confianza_posicion};
+}
 
+/**
+ * @brief Estima la pose del jugador por mínimos cuadrados ponderados con todos los flags visibles
+ *
+ * 1. Estimación inicial cerrada: la orientación sale de comparar los vectores
+ *    entre flags en el campo y en el marco de la vista; la posición, de la
+ *    media ponderada de lo que indica cada flag con esa orientación.
+ * 2. Refinamiento Gauss-Newton de (x, y, orientación) sobre distancias y
+ *    direcciones, con un número acotado de iteraciones.
+ * 3. Confianza a partir de la covarianza del ajuste, inflada si los residuos
+ *    son mayores de lo que explica la cuantización.
+ *
+ * @param flags Flags del agente con las medidas del último "see"
+ * @param datos Estructura Game_data donde se almacena la pose calculada
+ * @return Resumen de la localización
+ */
+EstadoLocalizacion relative2Abssolute(FlagsCampo const &flags, Game_data &datos)
+{
     // ======================================================
-    // DETECCIÓN Y MANEJO DE COLINEALIDAD
+    // MEDIDAS VISIBLES
     // ======================================================
-    // Si flag1 y flag2 están casi alineados (ángulos similares),
-    // usamos flag3 en lugar de flag2 para evitar indeterminación geométrica
-    float errorTheta = abs((theta1 - theta2) / theta1);
-    if (errorTheta < 0.01)  // Umbral de 1% de diferencia angular
+    array<MedidaFlag, NUM_FLAGS> medidas;
+    int n = 0;
+    int mas_cercano = 0;
+    for (int k = 0; k < flags.num_visibles; k++)
     {
-        // Intercambiamos flag2 con flag3
-        float auxTheta = theta2;
-        float auxD = d2;
-        float auxX = x2;
-        float auxY = y2;
-
-        theta2 = theta3;
-        d2 = d3;
-        x2 = x3;
-        y2 = y3;
-
-        theta3 = auxTheta;
-        d3 = auxD;
-        x3 = auxX;
-        y3 = auxY;
-
-        // cout << "f1 and f2 collinear, changing to f3" << endl;
+        knownFlags const &f = flags.visible(k);
+        if (f.distancia <= 0)
+            continue;
+        // Dirección del servidor en sentido horario: en el marco del campo es -direccion
+        double angulo = -(M_PI / 180) * f.direccion;
+        if (n == 0 || f.distancia < medidas[mas_cercano].d)
+            mas_cercano = n;
+        medidas[n++] = {static_cast<double>(f.x), static_cast<double>(f.y), f.distancia,
+                        cos(angulo), sin(angulo),
+                        1 / varianza_distancia(f.distancia), 1 / varianza_direccion(f.distancia)};
     }
 
-    // ======================================================
-    // CÁLCULOS TRIGONOMÉTRICOS PRELIMINARES
-    // ======================================================
-    // Conversión de grados a radianes para funciones trigonométricas
-    float cosTheta1 = cos((M_PI / 180) * theta1);
-    float sinTheta1 = sin((M_PI / 180) * theta1);
-    float cosTheta2 = cos((M_PI / 180) * theta2);
-    float sinTheta2 = sin((M_PI / 180) * theta2);
-
-    // ======================================================
-    // CÁLCULO DE DISTANCIA ENTRE FLAGS (LADO R DEL TRIÁNGULO)
-    // ======================================================
-    // Ley de cosenos: R² = d1² + d2² - 2*d1*d2*cos(θ1-θ2)
-    float R;
-    R = sqrt(d1 * d1 + d2 * d2 - 2 * d1 * d2 * cos((M_PI / 180) * (theta1 - theta2)));
-    // cout << "R: " << R << endl;
+    if (n == 0)
+        return sin_correccion(datos, 0);
+    // El flag más cercano (el de menor error absoluto) es la referencia de la estimación inicial
+    swap(medidas[0], medidas[mas_cercano]);
 
     // ======================================================
-    // CÁLCULO DEL ÁNGULO PSI (FASE)
+    // ESTIMACIÓN INICIAL
     // ======================================================
-    // Componentes para calcular atan2(b/a)
-    float psi; // Ángulo de fase en radianes
-    float b = d2 * sinTheta2 - d1 * sinTheta1;
-    float a = d1 * cosTheta1 - d2 * cosTheta2;
-
-    // Manejo de valores cercanos a cero para estabilidad numérica
-    if (abs(a) < 0.01) { a = 0; }
-    if (abs(b) < 0.01) { b = 0; }
-    // cout << "a: " << a << "\t" << "b: " << b << endl;
-
-    psi = atan2(b, a);  // atan2 maneja correctamente el cuadrante
-    // cout << "psiº: " << (180/M_PI)*psi << endl;
-
-    // ======================================================
-    // CÁLCULO DEL ÁNGULO BETA
-    // ======================================================
-    // cos(β) = (x1 - x2) / R (distancia entre flags en X dividido por R)
-    float beta; // Ángulo en radianes
-    float cosBeta = (x1 - x2) / R;
-    // cout << "cosBeta: " << cosBeta << endl;
-
-    // Validación del coseno (debe estar entre -1 y 1)
-    if (abs(cosBeta) <= 1)
+    double phi;
+    if (n >= 2)
     {
-        beta = acos(cosBeta);
+        // Orientación: suma de v_campo · conj(v_vista) para los vectores flag_0 -> flag_j,
+        // tanto más largos (y fiables) cuanto más cerca está flag_0
+        MedidaFlag const &m0 = medidas[0];
+        double re = 0, im = 0;
+        for (int j = 1; j < n; j++)
+        {
+            double wx = medidas[j].x - m0.x, wy = medidas[j].y - m0.y;
+            double bx = medidas[j].d * medidas[j].ux - m0.d * m0.ux;
+            double by = medidas[j].d * medidas[j].uy - m0.d * m0.uy;
+            re += wx * bx + wy * by;
+            im += wy * bx - wx * by;
+        }
+        if (re == 0 && im == 0)
+            return sin_correccion(datos, n);
+        phi = atan2(im, re);
     }
     else
     {
-        beta = 0; // Valor por defecto en caso de error numérico
-        // cout << "error, cosBeta > 1" << endl;
+        // Un solo flag no fija la orientación: se usa la anterior si se conoce
+        if (datos.jugador.orientacion_cuello == 999.0f)
+            return sin_correccion(datos, n);
+        phi = (M_PI / 180) * datos.jugador.orientacion_cuello;
     }
-    // cout << "beta: " << beta << endl;
 
-    // ======================================================
-    // DOS SOLUCIONES POSIBLES (AMBIGÜEDAD DE TRILATERACIÓN)
-    // ======================================================
-    // La trilateración con 2 puntos da 2 soluciones simétricas
-    float alpha1 = psi + beta;  // Solución 1
-    float alpha2 = psi - beta;  // Solución 2
-    // cout << "alpha1º: " << (180/M_PI)*alpha1 << "\t" << "alpha2º: " << (180/M_PI)*alpha2 << endl;
+    double x = 0, y = 0, suma_pesos = 0;
+    {
+        double c = cos(phi), s = sin(phi);
+        for (int i = 0; i < n; i++)
+        {
+            MedidaFlag const &m = medidas[i];
+            x += m.peso_d * (m.x - m.d * (c * m.ux - s * m.uy));
+            y += m.peso_d * (m.y - m.d * (s * m.ux + c * m.uy));
+            suma_pesos += m.peso_d;
+        }
+        x /= suma_pesos;
+        y /= suma_pesos;
+    }
 
     // ======================================================
-    // CÁLCULO DE LAS DOS POSICIONES CANDIDATAS
+    // REFINAMIENTO GAUSS-NEWTON
     // ======================================================
-    // Fórmula de rotación: posición = flag - d * [cos(θ)cos(α)-sin(θ)sin(α), cos(θ)sin(α)+sin(θ)cos(α)]
-    float xp1 = x1 - d1 * (cosTheta1 * cos(alpha1) - sinTheta1 * sin(alpha1));
-    float yp1 = y1 - d1 * (cosTheta1 * sin(alpha1) + sinTheta1 * cos(alpha1));
-    // cout << "x1: " << xp1 << "\t" << "y1: " << yp1 << endl;
+    // Estado (x, y, phi). Residuos: distancia medida - |flag - p| y el ángulo
+    // entre la dirección medida (girada por phi) y la predicha (seno del ángulo).
+    // Con un solo flag phi queda fija y solo se ajusta la posición.
+    int incognitas = (n >= 2) ? 3 : 2;
+    double H[3][3];
+    double chi2 = 0;
+    int iteraciones = 0;
+    while (true)
+    {
+        // Ecuaciones normales H·delta = g (H simétrica: solo el triángulo superior)
+        double h00 = 0, h01 = 0, h02 = 0, h11 = 0, h12 = 0, h22 = 0;
+        double g[3] = {0, 0, 0};
+        chi2 = 0;
 
-    float xp2 = x1 - d1 * (cosTheta1 * cos(alpha2) - sinTheta1 * sin(alpha2));
-    float yp2 = y1 - d1 * (cosTheta1 * sin(alpha2) + sinTheta1 * cos(alpha2));
-    // cout << "x2: " << xp2 << "\t" << "y2: " << yp2 << endl;
+        double c = cos(phi), s = sin(phi);
+        for (int i = 0; i < n; i++)
+        {
+            MedidaFlag const &m = medidas[i];
+            double dx = m.x - x, dy = m.y - y;
+            double rho2 = dx * dx + dy * dy;
+            if (rho2 < 1e-6)
+                continue;
+            double inv = 1 / sqrt(rho2);
+
+            // Distancia: h = rho, dh/d(x, y, phi) = (-dx/rho, -dy/rho, 0)
+            double r_d = m.d - rho2 * inv;
+            double jd0 = -dx * inv, jd1 = -dy * inv;
+
+            // Dirección: u_campo = R(phi)·u; r = sin(ángulo de (dx, dy) a u_campo)
+            // h = atan2(dy, dx) - phi, dh/d(x, y, phi) = (dy/rho², -dx/rho², -1)
+            double ux = c * m.ux - s * m.uy, uy = s * m.ux + c * m.uy;
+            double r_a = (dx * uy - dy * ux) * inv;
+            double ja0 = dy * inv * inv, ja1 = -dx * inv * inv;
+
+            double wd = m.peso_d, wa = m.peso_a;
+            h00 += wd * jd0 * jd0 + wa * ja0 * ja0;
+            h01 += wd * jd0 * jd1 + wa * ja0 * ja1;
+            h11 += wd * jd1 * jd1 + wa * ja1 * ja1;
+            h02 -= wa * ja0;
+            h12 -= wa * ja1;
+            h22 += wa;
+            g[0] += wd * jd0 * r_d + wa * ja0 * r_a;
+            g[1] += wd * jd1 * r_d + wa * ja1 * r_a;
+            g[2] -= wa * r_a;
+            chi2 += wd * r_d * r_d + wa * r_a * r_a;
+        }
+        H[0][0] = h00; H[0][1] = h01; H[0][2] = h02;
+        H[1][0] = h01; H[1][1] = h11; H[1][2] = h12;
+        H[2][0] = h02; H[2][1] = h12; H[2][2] = h22;
 
-    // ======================================================
-    // DESAMBIGUACIÓN USANDO EL TERCER FLAG
-    // ======================================================
-    // Calculamos distancia de cada solución candidata al tercer flag
-    float distPlayer1Flag3 = sqrt((xp1 - x3) * (xp1 - x3) + (yp1 - y3) * (yp1 - y3));
-    float distPlayer2Flag3 = sqrt((xp2 - x3) * (xp2 - x3) + (yp2 - y3) * (yp2 - y3));
+        if (iteraciones == MAX_ITERACIONES_LOCALIZACION)
+            break;
 
-    float x_player;
-    float y_player;
+        // Resolver H·delta = g por Cramer (2x2 si phi está fija)
+        double delta[3] = {0, 0, 0};
+        if (incognitas == 3)
+        {
+            double c00 = h11 * h22 - h12 * h12, c01 = h02 * h12 - h01 * h22, c02 = h01 * h12 - h02 * h11;
+            double det = h00 * c00 + h01 * c01 + h02 * c02;
+            if (abs(det) < 1e-12)
+                break;
+            double c11 = h00 * h22 - h02 * h02, c12 = h01 * h02 - h00 * h12, c22 = h00 * h11 - h01 * h01;
+            delta[0] = (c00 * g[0] + c01 * g[1] + c02 * g[2]) / det;
+            delta[1] = (c01 * g[0] + c11 * g[1] + c12 * g[2]) / det;
+            delta[2] = (c02 * g[0] + c12 * g[1] + c22 * g[2]) / det;
+        }
+        else
+        {
+            double det = h00 * h11 - h01 * h01;
+            if (abs(det) < 1e-12)
+                break;
+            delta[0] = (h11 * g[0] - h01 * g[1]) / det;
+            delta[1] = (h00 * g[1] - h01 * g[0]) / det;
+        }
 
-    // Calculamos error relativo para cada solución
-    float error1 = abs((d3 - distPlayer1Flag3) / d3);
-    float error2 = abs((d3 - distPlayer2Flag3) / d3);
+        x += delta[0];
+        y += delta[1];
+        phi += delta[2];
+        iteraciones++;
+        // Convergencia (1 cm, 0.06º): H y chi² del paso anterior bastan para la confianza
+        if (delta[0] * delta[0] + delta[1] * delta[1] < 1e-4 && abs(delta[2]) < 1e-3)
+            break;
+    }
 
     // ======================================================
-    // SELECCIÓN DE LA MEJOR SOLUCIÓN
+    // CONFIANZA
     // ======================================================
-    // Caso 1: Ambas soluciones tienen alto error -> tomamos promedio
-    if (error1 >= 0.5 && error2 >= 0.5)
+    // Covarianza del ajuste = inversa de H, inflada por el chi² reducido cuando
+    // los residuos superan el modelo de error. La confianza sale de la varianza
+    // de la posición (x + y) y el error de orientación del término de phi.
+    if (!isfinite(x) || !isfinite(y) || !isfinite(phi))
+        return sin_correccion(datos, n);
+    int grados_libertad = 2 * n - incognitas;
+    double escala = (grados_libertad > 0) ? max(1.0, chi2 / grados_libertad) : 1.0;
+    double varianza_pos, varianza_phi = -1;
+    double det_pos = H[0][0] * H[1][1] - H[0][1] * H[0][1];
+    if (incognitas == 3)
     {
-        x_player = (xp1 + xp2) / 2;
-        y_player = (yp1 + yp2) / 2;
-        // cout << "Position not accurate, approximation given" << endl;
+        double c00 = H[1][1] * H[2][2] - H[1][2] * H[1][2];
+        double c11 = H[0][0] * H[2][2] - H[0][2] * H[0][2];
+        double det = H[0][0] * c00 + H[0][1] * (H[0][2] * H[1][2] - H[0][1] * H[2][2]) +
+                     H[0][2] * (H[0][1] * H[1][2] - H[0][2] * H[1][1]);
+        if (!(det > 0))
+            return sin_correccion(datos, n);
+        varianza_pos = escala * (c00 + c11) / det;
+        varianza_phi = escala * det_pos / det;
     }
-    // Caso 2: Solución 1 tiene menor error
-    else if (error1 < error2)
+    else
     {
-        x_player = xp1;
-        y_player = yp1;
+        if (!(det_pos > 0))
+            return sin_correccion(datos, n);
+        varianza_pos = escala * (H[0][0] + H[1][1]) / det_pos;
     }
-    // Caso 3: Solución 2 tiene menor error
-    else
+
+    // ======================================================
+    // FUSIÓN CON LA ODOMETRÍA
+    // ======================================================
+    // La pose guardada es la predicha por la odometría para este ciclo. Si es
+    // compatible con el ajuste se promedian ambas según sus varianzas; si no
+    // (choque, move, deriva), manda el ajuste.
+    Player &jugador = datos.jugador;
+    float error_previo = error_posicion_jugador(jugador);
+    if (error_previo >= 0 && jugador.orientacion_cuello != 999.0f)
     {
-        x_player = xp2;
-        y_player = yp2;
+        double varianza_previa = static_cast<double>(error_previo) * error_previo;
+        double dx = jugador.x_absoluta - x, dy = jugador.y_absoluta - y;
+        if (dx * dx + dy * dy < UMBRAL_FUSION * UMBRAL_FUSION * (varianza_previa + varianza_pos))
+        {
+            double peso = varianza_pos / (varianza_previa + varianza_pos);
+            x += peso * dx;
+            y += peso * dy;
+            varianza_pos = varianza_previa * varianza_pos / (varianza_previa + varianza_pos);
+
+            double error_phi = (M_PI / 180) * jugador.error_orientacion;
+            double dphi = remainder((M_PI / 180) * jugador.orientacion_cuello - phi, 2 * M_PI);
+            if (varianza_phi > 0 && abs(dphi) < UMBRAL_FUSION * sqrt(error_phi * error_phi + varianza_phi))
+            {
+                peso = varianza_phi / (error_phi * error_phi + varianza_phi);
+                phi += peso * dphi;
+                varianza_phi = error_phi * error_phi * varianza_phi / (error_phi * error_phi + varianza_phi);
+            }
+        }
     }
+    float confianza = confianza_desde_error(static_cast<float>(sqrt(varianza_pos)));
 
     // ======================================================
     // ALMACENAMIENTO DEL RESULTADO
     // ======================================================
-    // cout << "xPlayer: " << x_player << "\t" << "yPlayer: " << y_player << endl;
-    datos.jugador.x_absoluta = x_player;
-    datos.jugador.y_absoluta = y_player;
+    // phi es la dirección de la vista (cuello); head_angle es horario, así que
+    // el cuerpo está en cuello + angulo_cuello
+    double grados = remainder(phi * (180 / M_PI), 360.0);
+    jugador.x_absoluta = static_cast<float>(x);
+    jugador.y_absoluta = static_cast<float>(y);
+    jugador.orientacion_cuello = static_cast<float>(grados);
+    jugador.orientacion_cuerpo = static_cast<float>(remainder(grados + jugador.angulo_cuello, 360.0));
+    if (varianza_phi >= 0)
+        jugador.error_orientacion = static_cast<float>(sqrt(varianza_phi) * (180 / M_PI));
+    jugador.confianza_posicion = confianza;
+    return {true, n, iteraciones, confianza};
 }
 
 /**
- * @brief Función de comparación para ordenar flags por distancia
+ * @brief Proyecta a coordenadas cartesianas los jugadores vistos y el balón del último "see"
  *
- * Predicado utilizado por algoritmos de ordenación para organizar
- * flags de más cercano a más lejano.
+ * Un solo recorrido sobre los arrays de distancia y dirección, sin saltos,
+ * que escribe los arrays x e y. La dirección del servidor es horaria y
+ * relativa a la vista, así que el ángulo en el marco de salida es
+ * cuello - direccion.
  *
- * @param f1 Primer flag a comparar
- * @param f2 Segundo flag a comparar
- * @return true si f1 está más cerca que f2, false en caso contrario
+ * @param datos Estructura con la pose, los jugadores vistos y el balón
  */
-bool compareDistance(const shared_ptr<knownFlags> &f1, const shared_ptr<knownFlags> &f2)
+void proyectar_observaciones(Game_data &datos)
 {
-    return (f1->distancia < f2->distancia);
+    Player const &jugador = datos.jugador;
+    Jugadores_Vistos &vistos = datos.jugadores_vistos;
+    bool pose = error_posicion_jugador(jugador) >= 0 && jugador.orientacion_cuello != 999.0f;
+    float ox = pose ? jugador.x_absoluta : 0.0f;
+    float oy = pose ? jugador.y_absoluta : 0.0f;
+    float cuello = pose ? jugador.orientacion_cuello : 0.0f;
+    constexpr float RADIANES = static_cast<float>(M_PI / 180);
+
+    for (int i = 0; i < vistos.num; i++)
+    {
+        float angulo = (cuello - vistos.direccion[i]) * RADIANES;
+        vistos.x[i] = ox + vistos.distancia[i] * cos(angulo);
+        vistos.y[i] = oy + vistos.distancia[i] * sin(angulo);
+    }
+    vistos.en_campo = pose;
+
+    Ball &ball = datos.ball;
+    float angulo = (cuello - ball.balon_direccion) * RADIANES;
+    ball.balon_x = ox + ball.balon_distancia * cos(angulo);
+    ball.balon_y = oy + ball.balon_distancia * sin(angulo);
+}
+
+/**
+ * @brief Aplica a la pose estimada el efecto de un comando enviado
+ *
+ * turn_neck mueve el cuello respecto al cuerpo dentro de los límites del
+ * servidor: la orientación del cuerpo se mantiene y la de la vista gira con el
+ * cuello. dash y turn pasan a la odometría, un move deja la posición sin
+ * conocer hasta el siguiente "see" y un kick deja incierta la velocidad del
+ * filtro del balón.
+ *
+ * @param comando Comando que se acaba de enviar
+ * @param datos Estructura Game_data con la pose del jugador
+ */
+void aplicar_comando_enviado(Comando const &comando, Game_data &datos)
+{
+    Player &jugador = datos.jugador;
+    if (comando.tipo == TipoComando::TurnNeck)
+    {
+        jugador.angulo_cuello = clamp(jugador.angulo_cuello + comando.parametros[0], ANGULO_CUELLO_MIN,
+                                      ANGULO_CUELLO_MAX);
+        if (jugador.orientacion_cuerpo != 999.0f)
+            jugador.orientacion_cuello = static_cast<float>(
+                remainder(jugador.orientacion_cuerpo - jugador.angulo_cuello, 360.0));
+    }
+    else if (comando.tipo == TipoComando::Dash)
+    {
+        registrar_dash(datos, comando.parametros[0], comando.parametros[1]);
+    }
+    else if (comando.tipo == TipoComando::Turn)
+    {
+        registrar_turn(datos, comando.parametros[0]);
+    }
+    else if (comando.tipo == TipoComando::Move)
+    {
+        jugador.confianza_posicion = 0;
+    }
+    else if (comando.tipo == TipoComando::Kick)
+    {
+        registrar_kick(datos.ball.filtro, comando.parametros[0]);
+    }
 }
@@ -12,8 +12,11 @@
 
 // Inclusión de dependencias necesarias
 #include "structs.h"           // Estructuras de datos del juego (Player, Ball, Goal, etc.)
-#include <memory>              // Punteros inteligentes (shared_ptr)
+#include "percepcion.h"        // Observación decodificada de un "see"
+#include "tabla_flags.h"       // Tabla constante de flags y FlagsCampo
+#include "comandos.h"          // Comandos enviados (giro del cuello)
 #include <string>              // Manipulación de cadenas
+#include <string_view>         // Mensaje recibido sin copia
 #include <vector>              // Contenedor de datos dinámico
 #include <unistd.h>            // Funcionalidades del sistema POSIX
 #include <cmath>               // Funciones matemáticas (sqrt, sin, cos, etc.)
@@ -21,15 +24,14 @@
 using namespace std;
 
 /**
- * @brief Inicializa el vector de flags conocidos con valores predeterminados
+ * @brief Inicializa los flags conocidos con valores predeterminados
  *
- * Esta función prepara la estructura de datos que almacenará las referencias
- * espaciales (flags) del campo. Cada flag representa un punto de referencia
- * con coordenadas absolutas conocidas.
+ * Copia la tabla constante de referencias espaciales (flags) del campo, con
+ * sus coordenadas absolutas conocidas y sin medidas.
  *
- * @param flags Referencia al vector de shared_ptr<knownFlags> a inicializar
+ * @param flags Flags del agente a inicializar
  */
-void inicializacion_flags(vector<shared_ptr<knownFlags>> &flags);
+void inicializacion_flags(FlagsCampo &flags);
 
 /**
  * @brief Procesa un mensaje de percepción para crear una matriz de valores absolutos
@@ -38,54 +40,79 @@ void inicializacion_flags(vector<shared_ptr<knownFlags>> &flags);
  * y extrae información sobre objetos visibles, almacenándolos como flags
  * con sus respectivas coordenadas relativas.
  *
- * @param mensaje String que contiene el mensaje de percepción del servidor
- * @param flags Referencia al vector donde se almacenarán los flags procesados
+ * @param observacion Objetos del mensaje de percepción, ya decodificados
+ * @param flags Flags del agente donde se almacenan las medidas y la lista de visibles
  */
-void crear_matriz_valores_absolutos(string const &mensaje, vector<shared_ptr<knownFlags>> &flags);
+void crear_matriz_valores_absolutos(ObservacionSee const &observacion, FlagsCampo &flags);
 
 /**
- * @brief Separa una línea de datos en componentes individuales
+ * @brief Imprime la matriz de flags para depuración
  *
- * Procesa una cadena que contiene múltiples valores espaciales (distancia,
- * ángulo, etc.) y los separa en tokens individuales para su procesamiento.
+ * Muestra en consola los flags del último "see", en el orden del mensaje,
+ * incluyendo coordenadas relativas y absolutas de cada objeto visible.
  *
- * @param linea Cadena de entrada con múltiples valores concatenados
- * @return String procesado o token individual
+ * @param flag Flags a imprimir
  */
-string vector_separar_string(string const &linea);
+void imprimir_matriz(FlagsCampo const &flag);
+
+/// Iteraciones máximas de Gauss-Newton por ciclo (acotan el coste de la localización)
+constexpr int MAX_ITERACIONES_LOCALIZACION = 5;
+
+/// Presupuesto de la localización por ciclo en microsegundos (lo comprueba bench_agent)
+constexpr double PRESUPUESTO_LOCALIZACION_US = 5.0;
+
+/// Distancia, en desviaciones típicas, por encima de la cual el ajuste no se fusiona con la odometría
+constexpr double UMBRAL_FUSION = 3.0;
+
+/// Límites del ángulo del cuello respecto al cuerpo (minneckang/maxneckang del servidor)
+constexpr float ANGULO_CUELLO_MIN = -90.0f;
+constexpr float ANGULO_CUELLO_MAX = 90.0f;
 
 /**
- * @brief Imprime la matriz de flags para depuración
- *
- * Muestra en consola el contenido completo del vector de flags,
- * incluyendo coordenadas relativas y absolutas de cada objeto visible.
- *
- * @param flag Referencia al vector de flags a imprimir
+ * @brief Resultado de una localización
  */
-void imprimir_matriz(vector<shared_ptr<knownFlags>> &flag);
+struct EstadoLocalizacion
+{
+    bool fijado;        ///< La posición se ha corregido con flags en este ciclo
+    int num_flags;      ///< Flags visibles usados en el ajuste
+    int iteraciones;    ///< Iteraciones de Gauss-Newton realizadas
+    float confianza;    ///< Confianza de la pose resultante (0..1)
+};
 
 /**
- * @brief Convierte coordenadas relativas a coordenadas absolutas
+ * @brief Estima la posición y orientación absolutas del jugador con todos los flags visibles
  *
- * Utiliza información de posición y orientación del jugador para transformar
- * coordenadas relativas (distancia y ángulo desde el jugador) a coordenadas
- * absolutas en el sistema de referencia del campo.
+ * Ajuste por mínimos cuadrados ponderados (Gauss-Newton) de la pose
+ * (x, y, orientación de la vista) a las distancias y direcciones de todos los
+ * flags vistos. Cada medida pesa según el error de cuantización del servidor.
+ * La orientación de la vista es la del cuello; la del cuerpo se obtiene
+ * sumando angulo_cuello (head_angle, horario). Con un solo flag se mantiene la
+ * orientación anterior. El resultado se fusiona con la pose que predijo la
+ * odometría si ambas son compatibles; sin flags se conserva la predicha.
  *
- * @param flags Vector de flags con coordenadas relativas a convertir
+ * @param flags Flags con las medidas del último "see"
  * @param datos Estructura con la información del juego y posición del jugador
+ * @return Resumen de la localización, con la confianza de la pose
  */
-void relative2Abssolute(vector<shared_ptr<knownFlags>> &flags, Game_data &datos);
+EstadoLocalizacion relative2Abssolute(FlagsCampo const &flags, Game_data &datos);
 
 /**
- * @brief Función de comparación para ordenar flags por distancia
+ * @brief Proyecta a coordenadas cartesianas los jugadores vistos y el balón del último "see"
+ *
+ * Con la pose conocida el resultado está en el campo; sin ella, en el marco
+ * de la vista propia (jugador en el origen mirando a +X), que conserva las
+ * distancias entre objetos. Jugadores_Vistos::en_campo indica cuál de los dos.
  *
- * Utilizada como criterio de ordenación para algoritmos de sorting.
- * Compara dos flags basándose en su distancia al jugador.
+ * @param datos Estructura con la pose, los jugadores vistos y el balón
+ */
+void proyectar_observaciones(Game_data &datos);
+
+/**
+ * @brief Aplica al modelo del mundo el efecto de un comando enviado (turn_neck, dash, turn, move, kick)
  *
- * @param f1 Primer flag a comparar
- * @param f2 Segundo flag a comparar
- * @return true si f1 está más cerca que f2, false en caso contrario
+ * @param comando Comando que se acaba de enviar
+ * @param datos Estructura con la pose del jugador
  */
-bool compareDistance(const shared_ptr<knownFlags> &f1, const shared_ptr<knownFlags> &f2);
+void aplicar_comando_enviado(Comando const &comando, Game_data &datos);
 
 #endif // POSICION_ABS_H
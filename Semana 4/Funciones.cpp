@@ -10,11 +10,17 @@
 #include <unistd.h>
 #include <string>
 #include <vector>
+#include <array>
+#include <utility>
+#include <charconv>
 #include <cmath>
 #include "structs.h"
 #include "utilities.h"
 #include "datos_area.h"
 #include "Funciones.h"
+#include "balon.h"
+#include "mundo.h"
+#include "numeros.h"
 
 /**
  * @brief Procesa mensaje inicial y posiciona al jugador
@@ -27,48 +33,47 @@
 void sendInitialMoveMessage(const string &str, MinimalSocket::udp::Udp<true> &udp_socket,
                      MinimalSocket::Address const &recep, Game_data &datos)
 {
-    struct Posicion { int x; int y; };
-    Posicion pos;
-    vector<string> player_ = separate_string_separator(str, ' '); // Ejemplo: "(init l 2 ...)"
+    Comando moveCommand;
+    procesar_init(str, datos, moveCommand);
+    udp_socket.sendTo(MinimalSocket::BufferViewConst{moveCommand.bytes.data(), moveCommand.longitud}, recep);
+}
 
-    if (player_.at(0) != "(init")
+/**
+ * @brief Procesa el mensaje inicial del servidor y escribe el comando de colocación
+ *
+ * @param str Mensaje de inicialización del servidor (ej: "(init l 2 before_kick_off)")
+ * @param datos Estructura de datos del juego (se rellenan lado y número)
+ * @param comando Salida: comando (move x y) según el número de jugador
+ */
+void procesar_init(string_view str, Game_data &datos, Comando &comando)
+{
+    ArbolSexp arbol;
+    if (!tokenizar(str, arbol) || texto_hijo(arbol, 0, 0) != "init") // Ejemplo: "(init l 2 ...)"
         throw runtime_error("Invalid initial message");
 
-    datos.jugador.lado_campo = player_.at(1);
-    datos.jugador.jugador_numero = player_[2];
+    string_view lado = texto_hijo(arbol, 0, 1);
+    string_view numero = texto_hijo(arbol, 0, 2);
+    datos.jugador.lado_campo = (lado == "l") ? Lado::Izquierdo : (lado == "r") ? Lado::Derecho : Lado::Desconocido;
+    if (leer_entero(numero, datos.jugador.jugador_numero) != ErrorNumero::Ninguno ||
+        datos.jugador.jugador_numero < 1 || datos.jugador.jugador_numero > 11)
+        throw runtime_error("Invalid initial message");
 
     // Asigna posiciones según número de jugador (formación 4-3-3)
-    switch (stoi(player_[2]) - 1)
-    {
-    case 0:  pos.x = -50; pos.y = 0; break;   // Portero
-    case 1:  pos.x = -35; pos.y = 20; break;  // Lateral derecho
-    case 2:  pos.x = -35; pos.y = 5; break;   // Central derecho
-    case 3:  pos.x = -35; pos.y = -5; break;    // Central izquierdo
-    case 4:  pos.x = -35; pos.y = -20; break;   // Lateral izquierdo
-    case 5:  pos.x = -15; pos.y = -10; break;   // Mediocentro derecho
-    case 6:  pos.x = -15; pos.y = 10; break;    // Mediocentro izquierdo
-    case 7:  pos.x = -12; pos.y = -2; break;   // Mediocentro central
-    case 8:  pos.x = -1;  pos.y = 15; break;   // Delantero derecho
-    case 9:  pos.x = -1;  pos.y = -15; break;  // Delantero izquierdo
-    case 10: pos.x = -5;  pos.y = 10; break;   // Delantero centro
-    }
-
-    auto moveCommand = "(move " + to_string(pos.x) + " " + to_string(pos.y) + ")";
-    udp_socket.sendTo(moveCommand, recep);
+    posicion_inicial(datos, comando);
 }
 
 /**
- * @brief Devuelve comando para posición inicial del jugador
+ * @brief Escribe el comando para la posición inicial del jugador
  *
  * @param datos Estructura de datos del juego
- * @return Comando de movimiento inicial
+ * @param comando Salida: comando de movimiento inicial
  */
-string posicion_inicial(Game_data &datos)
+void posicion_inicial(Game_data &datos, Comando &comando)
 {
     struct Posicion { int x; int y; };
     Posicion pos;
 
-    switch (stoi(datos.jugador.jugador_numero) - 1)
+    switch (datos.jugador.jugador_numero - 1)
     {
     case 0:  pos.x = -50; pos.y = 0; break;   // Portero
     case 1:  pos.x = -35; pos.y = 20; break;  // Lateral derecho
@@ -83,157 +88,141 @@ string posicion_inicial(Game_data &datos)
     case 10: pos.x = -5;  pos.y = 10; break;   // Delantero centro
     }
 
-    return "(move " + to_string(pos.x) + " " + to_string(pos.y) + ")";
+    move_(comando, pos.x, pos.y);
 }
 
 /**
  * @brief Procesa información del balón desde mensajes "see"
  *
- * @param message Mensaje de percepción
- * @param datos Estructura de datos del juego
- * @return Game_data actualizada con información del balón
+ * @param observacion Objetos del "see" ya decodificados
+ * @param datos Estructura de datos del juego (se actualiza el balón)
+ * @return Si se ha visto el balón (0 o 1 objetos)
  */
-Game_data handle_ball(string const &message, Game_data &datos)
+EstadoPercepcion handle_ball(ObservacionSee const &observacion, Game_data &datos)
 {
-    vector<string> vector_mensaje = separate_string(message);
     datos.ball.veo_balon = false;
 
-    for (auto const &v : vector_mensaje)
+    if (observacion.balon != -1 && observacion.objetos[observacion.balon].num_valores >= 2)
     {
-        if (v.find("(b)") != -1)
-        {
-            vector<string> vec = separate_string_separator(v, ' ');
-            if (vec.size() >= 3)
-            {
-                datos.ball.balon_distancia = vec.at(1);
-                datos.ball.balon_direccion = vec.at(2);
-                datos.ball.veo_balon = true;
-            }
-        }
+        ObjetoVisto const &balon = observacion.objetos[observacion.balon];
+        datos.ball.balon_distancia = balon.distancia;
+        datos.ball.balon_direccion = balon.direccion;
+        datos.ball.veo_balon = true;
     }
 
     if (!datos.ball.veo_balon)
     {
-        datos.ball.balon_distancia = "999.0";
-        datos.ball.balon_direccion = "999.0";
+        datos.ball.balon_distancia = DESCONOCIDO;
+        datos.ball.balon_direccion = DESCONOCIDO;
     }
 
-    return datos;
+    return {datos.ball.veo_balon, datos.ball.veo_balon ? 1 : 0};
 }
 
 /**
  * @brief Procesa información de porterías desde mensajes "see"
  *
- * @param message Mensaje de percepción
- * @param datos Estructura de datos del juego
- * @return Game_data actualizada con información de porterías
+ * @param observacion Objetos del "see" ya decodificados
+ * @param datos Estructura de datos del juego (se actualizan las porterías)
+ * @return Si se ha visto algún palo o centro de portería seguido, y cuántos
  */
-Game_data handle_porteria(string const &message, Game_data &datos)
+EstadoPercepcion handle_porteria(ObservacionSee const &observacion, Game_data &datos)
 {
+    // Palos que se siguen, resueltos al compilar con el hash de flags
+    constexpr int PALO_DERECHO_ABAJO = indice_flag("(f g r b)");
+    constexpr int PALO_IZQUIERDO_ABAJO = indice_flag("(f g l b)");
+
     // Inicializa valores por defecto
     datos.porteria.veo_porteria_contraria = false;
     datos.porteria.veo_porteria_propia = false;
-    datos.porteria.palo_abajo_distancia = "999.0";
-    datos.porteria.palo_abajo_direccion = "999.0";
-    datos.porteria.centro_distancia = "999.0";
-    datos.porteria.centro_direccion = "999.0";
-
-    vector<string> vector_mensaje = separate_string(message);
+    datos.porteria.palo_abajo_distancia = DESCONOCIDO;
+    datos.porteria.palo_abajo_direccion = DESCONOCIDO;
+    datos.porteria.centro_distancia = DESCONOCIDO;
+    datos.porteria.centro_direccion = DESCONOCIDO;
+    int vistos = 0;
 
-    for (auto const &v : vector_mensaje)
+    for (auto const &objeto : observacion.objetos)
     {
+        if (objeto.tipo != TipoObjeto::Flag && objeto.tipo != TipoObjeto::Porteria)
+            continue;
+        bool con_valores = objeto.num_valores >= 2;
+
         // Portería derecha (contraria si jugamos izquierda, propia si jugamos derecha)
-        if ((v.find("(f g r b)") != -1) && datos.jugador.lado_campo == "l")
+        if (objeto.flag == PALO_DERECHO_ABAJO && datos.jugador.lado_campo == Lado::Izquierdo)
         {
-            vector<string> vector_palo = separate_string_separator(v, ' ');
-            if (vector_palo.size() >= 6)
+            vistos++;
+            if (con_valores)
             {
-                datos.porteria.palo_abajo_distancia = vector_palo.at(4);
-                datos.porteria.palo_abajo_direccion = vector_palo.at(5);
+                datos.porteria.palo_abajo_distancia = objeto.distancia;
+                datos.porteria.palo_abajo_direccion = objeto.direccion;
             }
         }
-        else if ((v.find("(f g r b)") != -1) && datos.jugador.lado_campo == "r")
+        else if (objeto.flag == PALO_DERECHO_ABAJO && datos.jugador.lado_campo == Lado::Derecho)
         {
+            vistos++;
             datos.porteria.veo_porteria_propia = true;
         }
 
-        if ((v.find("(g r)") != -1) && datos.jugador.lado_campo == "l")
+        if (objeto.nombre == "(g r)" && datos.jugador.lado_campo == Lado::Izquierdo)
         {
+            vistos++;
             datos.porteria.veo_porteria_contraria = true;
-            vector<string> vector_porteria = separate_string_separator(v, ' ');
-            if (vector_porteria.size() >= 4)
+            if (con_valores)
             {
-                datos.porteria.centro_distancia = vector_porteria.at(2);
-                datos.porteria.centro_direccion = vector_porteria.at(3);
+                datos.porteria.centro_distancia = objeto.distancia;
+                datos.porteria.centro_direccion = objeto.direccion;
             }
         }
 
         // Portería izquierda (contraria si jugamos derecha, propia si jugamos izquierda)
-        if ((v.find("(f g l b)") != -1) && datos.jugador.lado_campo == "r")
+        if (objeto.flag == PALO_IZQUIERDO_ABAJO && datos.jugador.lado_campo == Lado::Derecho)
         {
-            vector<string> vector_palo = separate_string_separator(v, ' ');
-            if (vector_palo.size() >= 6)
+            vistos++;
+            if (con_valores)
             {
-                datos.porteria.palo_arriba_distancia = vector_palo.at(4);
-                datos.porteria.palo_arriba_direccion = vector_palo.at(5);
+                datos.porteria.palo_arriba_distancia = objeto.distancia;
+                datos.porteria.palo_arriba_direccion = objeto.direccion;
             }
         }
     }
 
-    return datos;
+    return {vistos > 0, vistos};
 }
 
 /**
  * @brief Procesa información de jugadores visibles
  *
- * @param message Mensaje de percepción
- * @param datos Estructura de datos del juego
- * @return Game_data actualizada con información de jugadores
+ * @param observacion Objetos del "see" ya decodificados
+ * @param datos Estructura de datos del juego (se rellena el almacén de jugadores)
+ * @return Si se ha visto algún jugador (con o sin dorsal), y cuántos
  */
-Game_data handle_jugadores_vistos(string const &message, Game_data &datos)
+EstadoPercepcion handle_jugadores_vistos(ObservacionSee const &observacion, Game_data &datos)
 {
-    datos.jugadores_vistos.veo_equipo = false;
-    datos.jugadores_vistos.jugadores.clear();
-
-    vector<string> vector_mensaje = separate_string(message);
-    vector<vector<string>> vector_jugadores_cerca;
-    vector<vector<string>> vector_contrarios;
+    Jugadores_Vistos &vistos = datos.jugadores_vistos;
+    vistos.limpiar();
 
-    string encontrar_jugador_nuestro_equipo = "(p \"" + datos.nombre_equipo + "\" ";
-
-    for (auto const &v : vector_mensaje)
+    for (auto const &objeto : observacion.objetos)
     {
-        if (v.find(encontrar_jugador_nuestro_equipo) != -1)
+        if (objeto.num_valores < 2)
+            continue;
+
+        // Los jugadores sin dorsal (lejanos) se guardan con numero = 0
+        if (objeto.tipo == TipoObjeto::Companero)
         {
-            vector<string> vector_jugador = separate_string_separator(v, ' ');
-            if (vector_jugador.size() >= 5)
-            {
-                vector_jugador.at(2).pop_back();
-                vector_jugadores_cerca.push_back({vector_jugador.at(2), vector_jugador.at(3), vector_jugador.at(4)});
-                datos.jugadores_vistos.veo_equipo = true;
-            }
+            vistos.anadir(objeto.numero, objeto.distancia, objeto.direccion, true, objeto.portero);
         }
-        else if (v.find("(p \"") != -1)
+        else if (objeto.tipo == TipoObjeto::Contrario)
         {
-            vector<string> contrarios = separate_string_separator(v, ' ');
-            if (contrarios.at(1) != datos.jugador.nombre_equipo && contrarios.size() >= 5)
+            if (objeto.numero >= 0 && objeto.numero <= 11)
             {
-                contrarios.at(2).pop_back();
-                if (contrarios.at(2) < "12" && contrarios.at(2) > "0")
-                {
-                    vector_contrarios.push_back({contrarios.at(2), contrarios.at(3), contrarios.at(4)});
-                    datos.jugadores_vistos.veo_equipo_contrario = true;
-                }
+                vistos.anadir(objeto.numero, objeto.distancia, objeto.direccion, false, objeto.portero);
+                vistos.veo_equipo_contrario = true;
             }
         }
     }
+    vistos.veo_equipo = vistos.num_companeros > 0;
 
-    if (datos.jugadores_vistos.veo_equipo)
-        datos.jugadores_vistos.jugadores = vector_jugadores_cerca;
-    if (datos.jugadores_vistos.veo_equipo_contrario)
-        datos.jugadores_vistos.jugadores_contrario = vector_contrarios;
-
-    return datos;
+    return {vistos.num > 0, vistos.num};
 }
 
 /**
@@ -244,7 +233,37 @@ Game_data handle_jugadores_vistos(string const &message, Game_data &datos)
  */
 bool tengo_balon(Game_data const &datos)
 {
-    return (stod(datos.ball.balon_distancia) <= 1 && datos.ball.balon_distancia != "999.0");
+    return datos.ball.balon_distancia <= 1;
+}
+
+/// Mitad del ángulo de visión normal del servidor (grados)
+constexpr float SEMIANGULO_VISTA = 45.0f;
+
+/**
+ * @brief Gira el cuerpo hacia la posición prevista del balón cuando no se ve
+ *
+ * Usa la predicción del filtro para el ciclo en que el giro tiene efecto. Solo
+ * se fía de ella si el balón se vio hace poco y se conoce la pose propia.
+ *
+ * @param datos Estructura de datos del juego
+ * @param comando Comando a rellenar con el giro
+ * @return true si se ha generado el giro, false si no hay predicción fiable
+ */
+bool girar_hacia_balon_previsto(Game_data const &datos, Comando &comando)
+{
+    FiltroBalon const &filtro = datos.ball.filtro;
+    Player const &jugador = datos.jugador;
+    if (!balon_localizado(filtro) || jugador.confianza_posicion <= 0 || jugador.orientacion_cuerpo == 999.0f)
+        return false;
+
+    Punto balon = posicion_balon_en(filtro, 1);
+    float angulo = atan2(balon.y - jugador.y_absoluta, balon.x - jugador.x_absoluta) * static_cast<float>(180 / M_PI);
+    // Si debería estar a la vista y no se ve, la predicción ya no vale
+    if (abs(remainder(jugador.orientacion_cuello - angulo, 360.0)) < SEMIANGULO_VISTA)
+        return false;
+    // El servidor gira en sentido horario con momentos positivos
+    turn(comando, static_cast<float>(round(remainder(jugador.orientacion_cuerpo - angulo, 360.0))));
+    return true;
 }
 
 /**
@@ -257,42 +276,49 @@ bool voy_balon(Game_data &datos)
 {
     // Devolver true si tenemos que ir a por el balon, falso si no
 
-    // Variables de jugador a balon
-    auto db = stod(datos.ball.balon_distancia);
-    auto thetab = -(M_PI / 180) * stod(datos.ball.balon_direccion);
+    // Mi distancia al balon al cuadrado; las posiciones ya estan proyectadas
+    // (proyectar_observaciones), asi que basta comparar distancias al cuadrado
+    float db2 = datos.ball.balon_distancia * datos.ball.balon_distancia;
+    float bx = datos.ball.balon_x, by = datos.ball.balon_y;
 
-    vector<vector<string>> jugadores = datos.jugadores_vistos.jugadores;
+    Jugadores_Vistos const &vistos = datos.jugadores_vistos;
+    MundoJugadores const &mundo = datos.mundo;
+    int num_companeros = 0;
 
     int contador{0};
-    if (jugadores.size() > 0)
+    if (vistos.en_campo)
     {
-        for (auto const jugador : jugadores)
+        // Con la pose conocida cuentan tambien los compañeros recordados fuera de la vista
+        int propio = hueco_jugador(true, datos.jugador.jugador_numero);
+        for (int h = 0; h < JUGADORES_POR_EQUIPO; h++)
         {
-            // variables 3º jugador a balon
-            auto dp = stod(jugador.at(1));
-            auto thetap = -(M_PI / 180) * stod(jugador.at(2));
-
-            auto d = sqrt(db * db + dp * dp - 2 * db * dp * cos(thetab - thetap));
-
-            // Si mi distancia al balon es mayor devolvemos false
-            // Si mi distancia al balon es menor comparada con 3º jugador devolvemos true
-            // Hacemos return si encontramos algun true
-
-            if (db > d)
-            {
-                contador++;
-            }
+            if (h == propio || confianza_jugador(mundo, h, mundo.tiempo) < CONFIANZA_MIN_MUNDO)
+                continue;
+            Punto p = posicion_jugador_en(mundo, h, mundo.tiempo);
+            float dx = p.x - bx, dy = p.y - by;
+            contador += db2 > dx * dx + dy * dy;
+            num_companeros++;
+        }
+    }
+    else
+    {
+        num_companeros = vistos.num_companeros;
+        for (int i = 0; i < vistos.num; i++)
+        {
+            // Cuenta los compañeros mas cerca del balon que yo
+            float dx = vistos.x[i] - bx, dy = vistos.y[i] - by;
+            contador += vistos.companero[i] && db2 > dx * dx + dy * dy;
         }
     }
-    if ((datos.jugador.jugador_numero == "4" || datos.jugador.jugador_numero == "2" || datos.jugador.jugador_numero == "5") && stof(datos.ball.balon_distancia) < 10)
+    if ((datos.jugador.jugador_numero == 4 || datos.jugador.jugador_numero == 2 || datos.jugador.jugador_numero == 5) && datos.ball.balon_distancia < 10)
     {
         return true;
     }
 
-    if (contador > (int)(jugadores.size() / 2))
+    if (contador > num_companeros / 2)
         return false;
     // Si no vemos a nadie cerca, tambien voy
-    if (jugadores.size() == 0)
+    if (num_companeros == 0)
     {
         // Si no vemos a jugadores cerca deberiamos de ir a por el balon, por ello debemos devolver true
         // pero los jugadores tienden a ir demasiado al balon, por lo que agregamos una probabilidad de no ir
@@ -310,14 +336,12 @@ bool voy_balon(Game_data &datos)
  */
 bool cerca_enemigo(Game_data &datos)
 {
+    Jugadores_Vistos const &vistos = datos.jugadores_vistos;
     float distancia{1000};
-    for (auto const &jugador : datos.jugadores_vistos.jugadores_contrario)
+    for (int i = 0; i < vistos.num; i++)
     {
-        if (datos.jugadores_vistos.veo_equipo_contrario)
-        {
-            if (stof(jugador.at(1)) < distancia)
-                distancia = stof(jugador.at(1));
-        }
+        if (!vistos.companero[i] && vistos.distancia[i] < distancia)
+            distancia = vistos.distancia[i];
     }
     if (distancia < 10)
         return true;
@@ -334,108 +358,45 @@ void jugador_cerca_pase(Game_data &datos)
 {
     // Guardar el numero, distancia y direccion del jugador mas cercano a ti y con numero mayor
     // Se guarda en estructura nueva Jugador Cercano
-    if (!cerca_enemigo(datos))
-    {
-        vector<vector<string>> jugadoresCerca = datos.jugadores_vistos.jugadores;
-        vector<vector<string>> jugadoresNumeroMayor;
-
-        // Evaluamos todos los jugadores
-        for (auto &jugador : jugadoresCerca)
-        {
-            // aceptamos pases de menor numero si somos delanteros a centrocampistas
-            bool somosDelanteros = (datos.jugador.jugador_numero == "11" || datos.jugador.jugador_numero == "10" ||
-                                    datos.jugador.jugador_numero == "9");
-
-            if (somosDelanteros && stod(jugador.at(0)) >= 5)
-            {
-                jugadoresNumeroMayor.push_back(jugador);
-            }
-            else if (stod(jugador.at(0)) > stod(datos.jugador.jugador_numero) && stod(jugador.at(1)) > 8)
-            {
-                jugadoresNumeroMayor.push_back(jugador);
-            }
-        }
-
-        if (jugadoresNumeroMayor.size() != 0)
-        {
-            // Ordenamos el vector juagdoresNumeroMayor por menor distancia
-            sort(jugadoresNumeroMayor.begin(), jugadoresNumeroMayor.end(), [](const vector<string> &a, const vector<string> &b)
-                 { return stod(a.at(1)) > stod(b.at(1)); });//cambio <
-            if (datos.jugador.jugador_numero == "1" || datos.jugador.jugador_numero == "2" || datos.jugador.jugador_numero == "3" ||
-                datos.jugador.jugador_numero == "4" || datos.jugador.jugador_numero == "5")
-            {
-                sort(jugadoresNumeroMayor.begin(), jugadoresNumeroMayor.end(), [](const vector<string> &a, const vector<string> &b)
-                     { return stod(a.at(1)) > stod(b.at(1)); });
-            }
-            if(datos.jugador.jugador_numero == "6" || datos.jugador.jugador_numero == "7" || datos.jugador.jugador_numero == "8")
-            {
-                sort(jugadoresNumeroMayor.begin(), jugadoresNumeroMayor.end(), [](const vector<string> &a, const vector<string> &b)
-                     { return stod(a.at(0)) > stod(b.at(0)); });
-            }
-            // Si hay jugadores con numero mayor
-
-            datos.jugadorCerca.hayJugador = true;
-            datos.jugadorCerca.distancia = jugadoresNumeroMayor.at(0).at(1);
-            datos.jugadorCerca.direccion = jugadoresNumeroMayor.at(0).at(2);
-            datos.jugadorCerca.numero_jugador = jugadoresNumeroMayor.at(0).at(0);
-        }
-        else
-        {
-            datos.jugadorCerca.hayJugador = false;
-        }
+    // (con o sin enemigos cerca el criterio es el mismo)
+    Jugadores_Vistos const &vistos = datos.jugadores_vistos;
+    int numero_propio = datos.jugador.jugador_numero;
+
+    // aceptamos pases de menor numero si somos delanteros a centrocampistas
+    bool somosDelanteros = (numero_propio == 11 || numero_propio == 10 || numero_propio == 9);
+    // Los centrocampistas prefieren el de mayor numero; el resto, el mas lejano
+    bool porNumero = (numero_propio == 6 || numero_propio == 7 || numero_propio == 8);
+
+    // Recorremos los compañeros sin copiarlos, quedandonos con el mejor candidato
+    int mejor = -1;
+    for (int i = 0; i < vistos.num; i++)
+    {
+        if (!vistos.companero[i])
+            continue;
+        // Los compañeros sin dorsal (numero = 0) nunca son candidatos: el pase necesita el dorsal
+        bool candidato = (somosDelanteros && vistos.numero[i] >= 5) ||
+                         (vistos.numero[i] > numero_propio && vistos.distancia[i] > 8);
+        if (!candidato)
+            continue;
+
+        // En empate gana el primero del mensaje (mismo orden que la ordenación anterior)
+        if (mejor == -1 ||
+            (porNumero && (vistos.numero[i] > vistos.numero[mejor] ||
+                           (vistos.numero[i] == vistos.numero[mejor] && vistos.distancia[i] > vistos.distancia[mejor]))) ||
+            (!porNumero && vistos.distancia[i] > vistos.distancia[mejor]))
+            mejor = i;
+    }
+
+    if (mejor != -1)
+    {
+        datos.jugadorCerca.hayJugador = true;
+        datos.jugadorCerca.distancia = vistos.distancia[mejor];
+        datos.jugadorCerca.direccion = vistos.direccion[mejor];
+        datos.jugadorCerca.numero_jugador = vistos.numero[mejor];
     }
     else
     {
-        vector<vector<string>> jugadoresCerca = datos.jugadores_vistos.jugadores;
-        vector<vector<string>> jugadoresNumeroMayor;
-
-        // Evaluamos todos los jugadores
-        for (auto &jugador : jugadoresCerca)
-        {
-            // aceptamos pases de menor numero si somos delanteros a centrocampistas
-            bool somosDelanteros = (datos.jugador.jugador_numero == "11" || datos.jugador.jugador_numero == "10" ||
-                                    datos.jugador.jugador_numero == "9");
-
-            if (somosDelanteros && stod(jugador.at(0)) >= 5) // jugador distancia en mayor de 11
-            {
-                jugadoresNumeroMayor.push_back(jugador);
-            }
-            else if (stod(jugador.at(0)) > stod(datos.jugador.jugador_numero) && stod(jugador.at(1)) > 8)
-            {
-                jugadoresNumeroMayor.push_back(jugador);
-            }
-        }
-
-        if (jugadoresNumeroMayor.size() != 0)
-        {
-            // Ordenamos el vector juagdoresNumeroMayor por mayor distancia
-            sort(jugadoresNumeroMayor.begin(), jugadoresNumeroMayor.end(), [](const vector<string> &a, const vector<string> &b)
-                 { return stod(a.at(1)) > stod(b.at(1)); });
-            if (datos.jugador.jugador_numero == "1" || datos.jugador.jugador_numero == "2" || datos.jugador.jugador_numero == "3" ||
-                datos.jugador.jugador_numero == "4" || datos.jugador.jugador_numero == "5")
-            {
-                sort(jugadoresNumeroMayor.begin(), jugadoresNumeroMayor.end(), [](const vector<string> &a, const vector<string> &b)
-                     { return stod(a.at(1)) > stod(b.at(1)); });
-            }
-            if(datos.jugador.jugador_numero == "6" || datos.jugador.jugador_numero == "7" || datos.jugador.jugador_numero == "8")
-            {
-                sort(jugadoresNumeroMayor.begin(), jugadoresNumeroMayor.end(), [](const vector<string> &a, const vector<string> &b)
-                     { return stod(a.at(0)) > stod(b.at(0)); });
-            }
-            // Si hay jugadores con numero mayor
-            // Guardamos el jugador con mayor numero
-            // for (auto &j : jugadoresNumeroMayor)
-            //     cout << "-> " << j.at(1) << endl;
-            // cout << "fin" << endl;
-            datos.jugadorCerca.hayJugador = true;
-            datos.jugadorCerca.distancia = jugadoresNumeroMayor.at(0).at(1);
-            datos.jugadorCerca.direccion = jugadoresNumeroMayor.at(0).at(2);
-            datos.jugadorCerca.numero_jugador = jugadoresNumeroMayor.at(0).at(0);
-        }
-        else
-        {
-            datos.jugadorCerca.hayJugador = false;
-        }
+        datos.jugadorCerca.hayJugador = false;
     }
 }
 
@@ -443,9 +404,9 @@ void jugador_cerca_pase(Game_data &datos)
  * @brief Genera comando de pase al mejor compañero disponible
  *
  * @param datos Estructura de datos del juego
- * @return Comando de pase o patada segura
+ * @param comando Salida: comando de pase o patada segura
  */
-string pase(Game_data &datos)
+void pase(Game_data &datos, Comando &comando)
 {
     jugador_cerca_pase(datos);
     // Si vemos a un jugador cerca con un numero mayor al nuestro
@@ -455,58 +416,178 @@ string pase(Game_data &datos)
     {
         int potencia;
         // Hay jugador cerca, calculamos potencia necesaria del pase
-        if (stof(datos.jugadorCerca.distancia) >= 20)
-            potencia = static_cast<int>(stof(datos.jugadorCerca.distancia) * 2.7);
-        else if (stof(datos.jugadorCerca.distancia) < 20 && stof(datos.jugadorCerca.distancia) > 10)
-            potencia = static_cast<int>(stof(datos.jugadorCerca.distancia) * 2.4);
+        if (datos.jugadorCerca.distancia >= 20)
+            potencia = static_cast<int>(datos.jugadorCerca.distancia * 2.7);
+        else if (datos.jugadorCerca.distancia < 20 && datos.jugadorCerca.distancia > 10)
+            potencia = static_cast<int>(datos.jugadorCerca.distancia * 2.4);
         else
         {
-            potencia = static_cast<int>(stof(datos.jugadorCerca.distancia) * 2.3);
+            potencia = static_cast<int>(datos.jugadorCerca.distancia * 2.3);
         }
 
         if (potencia > 100)
         {
-            return "(kick 100 " + datos.jugadorCerca.direccion + ")";
+            kick(comando, 100, datos.jugadorCerca.direccion);
         }
         else
         {
-            return "(kick " + to_string(potencia) + " " + datos.jugadorCerca.direccion + ")";
+            kick(comando, potencia, datos.jugadorCerca.direccion);
         }
     }
     else
     {
         // No hay nadie cerca, pase corto hacia atras para girar la cabeza
-        return "(kick 12 130)";
+        kick(comando, 12, 130);
+    }
+}
+
+/// Nombre de cada modo de juego tal como lo anuncia el árbitro, sin lado ni marcador
+static constexpr pair<string_view, ModoJuego> NOMBRES_MODO_JUEGO[] = {
+    {"before_kick_off", ModoJuego::BeforeKickOff},
+    {"play_on", ModoJuego::PlayOn},
+    {"time_over", ModoJuego::TimeOver},
+    {"kick_off", ModoJuego::KickOff},
+    {"kick_in", ModoJuego::KickIn},
+    {"free_kick", ModoJuego::FreeKick},
+    {"indirect_free_kick", ModoJuego::IndirectFreeKick},
+    {"corner_kick", ModoJuego::CornerKick},
+    {"goal_kick", ModoJuego::GoalKick},
+    {"goal", ModoJuego::Goal},
+    {"drop_ball", ModoJuego::DropBall},
+    {"offside", ModoJuego::Offside},
+    {"penalty_kick", ModoJuego::PenaltyKick},
+    {"foul_charge", ModoJuego::FoulCharge},
+    {"foul_push", ModoJuego::FoulPush},
+    {"back_pass", ModoJuego::BackPass},
+    {"free_kick_fault", ModoJuego::FreeKickFault},
+    {"catch_fault", ModoJuego::CatchFault},
+    {"goalie_catch_ball", ModoJuego::GoalieCatchBall},
+    {"yellow_card", ModoJuego::YellowCard},
+    {"red_card", ModoJuego::RedCard},
+    {"half_time", ModoJuego::HalfTime},
+    {"extra_half_time", ModoJuego::ExtraHalfTime},
+    {"time_extended", ModoJuego::TimeExtended},
+    {"time_up", ModoJuego::TimeUp},
+};
+
+/**
+ * @brief Lee lo que sigue al nombre de un modo: "", "_l", "_r" y opcionalmente "_N"
+ *
+ * @param resto Texto tras el nombre (ej: "_l_2" en "goal_l_2")
+ * @param lado Lado leído (Desconocido si no lo lleva)
+ * @return false si el resto no es un sufijo válido (ej: "_kick_l" tras "goal")
+ */
+static bool leer_sufijo_evento(string_view resto, Lado &lado)
+{
+    lado = Lado::Desconocido;
+    if (resto.size() >= 2 && resto[0] == '_' && (resto[1] == 'l' || resto[1] == 'r') &&
+        (resto.size() == 2 || resto[2] == '_'))
+    {
+        lado = (resto[1] == 'l') ? Lado::Izquierdo : Lado::Derecho;
+        resto.remove_prefix(2);
+    }
+    if (resto.empty())
+        return true;
+
+    // Marcador o dorsal (goal_l_2, yellow_card_r_5)
+    int numero = 0;
+    return resto[0] == '_' && leer_entero(resto.substr(1), numero) == ErrorNumero::Ninguno;
+}
+
+/**
+ * @brief Decodifica el texto de un mensaje del árbitro en modo de juego y lado
+ *
+ * @param texto Evento del árbitro (ej: "kick_off_l", "goal_r_1", "play_on")
+ * @return Evento decodificado; ModoJuego::Desconocido si no se reconoce
+ */
+EventoArbitro decodificar_evento_arbitro(string_view texto)
+{
+    for (auto const &[nombre, modo] : NOMBRES_MODO_JUEGO)
+    {
+        Lado lado;
+        if (texto.starts_with(nombre) && leer_sufijo_evento(texto.substr(nombre.size()), lado))
+            return EventoArbitro(modo, lado);
+    }
+    return EventoArbitro();
+}
+
+/// Acción al entrar en un modo de juego
+using AccionModoJuego = void (*)(EventoArbitro const &evento, Game_data &datos);
+
+/**
+ * @brief Gol: si lo ha marcado el contrario, sacamos nosotros de centro
+ */
+static void al_entrar_gol(EventoArbitro const &evento, Game_data &datos)
+{
+    if ((evento.lado == Lado::Izquierdo && datos.lado_campo == Lado::Derecho) ||
+        (evento.lado == Lado::Derecho && datos.lado_campo == Lado::Izquierdo))
+    {
+        datos.flag_kick_off = true;
     }
 }
 
+/**
+ * @brief Descanso: la segunda parte empieza con saque de centro
+ */
+static void al_entrar_descanso(EventoArbitro const &, Game_data &datos)
+{
+    datos.flag_kick_off = true;
+}
+
+/**
+ * @brief Tabla de transiciones: acción a ejecutar al entrar en cada modo (nullptr si ninguna)
+ */
+static constexpr array<AccionModoJuego, static_cast<size_t>(ModoJuego::NumModos)> construir_transiciones()
+{
+    array<AccionModoJuego, static_cast<size_t>(ModoJuego::NumModos)> tabla{};
+    tabla[static_cast<size_t>(ModoJuego::Goal)] = al_entrar_gol;
+    tabla[static_cast<size_t>(ModoJuego::HalfTime)] = al_entrar_descanso;
+    tabla[static_cast<size_t>(ModoJuego::ExtraHalfTime)] = al_entrar_descanso;
+    return tabla;
+}
+
+static constexpr auto AL_ENTRAR_MODO = construir_transiciones();
+
+/**
+ * @brief Registra un evento del árbitro y, si cambia el modo o el lado, dispara su transición
+ *
+ * @param evento Evento ya decodificado
+ * @param datos Estructura de datos del juego
+ */
+static void actualizar_evento(EventoArbitro const &evento, Game_data &datos)
+{
+    if (evento == datos.evento)
+        return;
+    datos.evento_anterior = datos.evento;
+    datos.evento = evento;
+    if (AccionModoJuego accion = AL_ENTRAR_MODO[static_cast<size_t>(evento.modo)])
+        accion(evento, datos);
+}
+
 /**
  * @brief Procesa mensajes del servidor y actualiza estado del juego
  *
- * @param mensaje Mensaje recibido del servidor
+ * @param arbol Mensaje recibido del servidor, ya tokenizado
+ * @param observacion Objetos del mensaje si era un "see" (decodificar_see)
  * @param datos Estructura de datos del juego
  */
-void send_message_funtion(string const &mensaje, Game_data &datos)
+void send_message_funtion(ArbolSexp const &arbol, ObservacionSee const &observacion, Game_data &datos)
 {
-    if (mensaje.find("hear") != -1)
+    string_view tipo = texto_hijo(arbol, 0, 0);
+
+    if (tipo == "hear") // (hear 0 referee kick_off_l)
     {
-        vector<string> vector_mensaje_1 = separate_string(mensaje); // ("init r 1 before_kick_off")
-        vector_mensaje_1 = separate_string_separator(vector_mensaje_1.at(0), ' ');
-        if (vector_mensaje_1.at(0) != "hear")
-        {
+        if (hijo(arbol, 0, 3) == -1)
             throw runtime_error("error en el mensaje hear");
-            return;
-        }
-        datos.evento_anterior = datos.evento;
-        datos.evento = vector_mensaje_1.at(3);
+        if (texto_hijo(arbol, 0, 2) == "referee")
+            actualizar_evento(decodificar_evento_arbitro(texto_hijo(arbol, 0, 3)), datos);
     }
 
-    if (mensaje.find("see") != -1)
+    if (observacion.valida) // (see 12 ((b) 12 12) ...)
     {
-        vector<string> vector_mensaje = separate_string(mensaje); // ("see ((b) 12 12)")
-        handle_ball(vector_mensaje.at(0), datos);
-        handle_porteria(vector_mensaje.at(0), datos);
-        handle_jugadores_vistos(vector_mensaje.at(0), datos);
+        handle_ball(observacion, datos);
+        handle_porteria(observacion, datos);
+        handle_jugadores_vistos(observacion, datos);
     }
 }
 
@@ -514,63 +595,68 @@ void send_message_funtion(string const &mensaje, Game_data &datos)
  * @brief Genera comportamiento ofensivo según distancia al balón
  *
  * @param datos Estructura de datos del juego
- * @return Comando de ataque o "0" si no aplica
+ * @param comando Salida: comando de ataque (solo si aplica)
+ * @return true si se ha generado un comando de ataque
  */
-string ataque(Game_data &datos)
+bool ataque(Game_data &datos, Comando &comando)
 {
-    string resultado;
-
     // Si somos el jugador que va al balon, y su distancia es < 25
-    if ((datos.jugador.jugador_numero == "10" || datos.jugador.jugador_numero == "11" || datos.jugador.jugador_numero == "9") &&
-        stod(datos.ball.balon_distancia) <= 30 && stod(datos.ball.balon_distancia) > 1)
+    if ((datos.jugador.jugador_numero == 10 || datos.jugador.jugador_numero == 11 || datos.jugador.jugador_numero == 9) &&
+        datos.ball.balon_distancia <= 30 && datos.ball.balon_distancia > 1)
     {
-        return "(dash 100 " + datos.ball.balon_direccion + ")";
+        dash(comando, 100, datos.ball.balon_direccion);
+        return true;
     }
 
     // Si somos el jugador que va al balon, y su distancia es < 25
-    if (voy_balon(datos) && stod(datos.ball.balon_distancia) <= 20 && stod(datos.ball.balon_distancia) > 1)
+    if (voy_balon(datos) && datos.ball.balon_distancia <= 20 && datos.ball.balon_distancia > 1)
     {
-        return "(dash 100 " + datos.ball.balon_direccion + ")";
+        dash(comando, 100, datos.ball.balon_direccion);
+        return true;
     }
 
     // Si somos el 11, hay corner y la distancia al balon > 1
-    bool corner = (datos.evento.find("kick_off_l") == -1 && datos.jugador.jugador_numero == "11" && datos.jugador.lado_campo == "l") ||
-                  (datos.evento.find("kick_off_r") == -1 && datos.jugador.jugador_numero == "11" && datos.jugador.lado_campo == "r");
+    bool corner = (!datos.evento.es(ModoJuego::KickOff, Lado::Izquierdo) && datos.jugador.jugador_numero == 11 && datos.jugador.lado_campo == Lado::Izquierdo) ||
+                  (!datos.evento.es(ModoJuego::KickOff, Lado::Derecho) && datos.jugador.jugador_numero == 11 && datos.jugador.lado_campo == Lado::Derecho);
 
-    if (datos.jugador.jugador_numero == "11" && stod(datos.ball.balon_distancia) > 1 && corner)
+    if (datos.jugador.jugador_numero == 11 && datos.ball.balon_distancia > 1 && corner)
     {
-        return "(dash 100 " + datos.ball.balon_direccion + ")";
+        dash(comando, 100, datos.ball.balon_direccion);
+        return true;
     }
 
     // Somos cualquier jugador y la distancia al balon >25
-    if (datos.jugador.jugador_numero != "1" && stod(datos.ball.balon_distancia) > 20 && stod(datos.ball.balon_distancia) < 40)
+    if (datos.jugador.jugador_numero != 1 && datos.ball.balon_distancia > 20 && datos.ball.balon_distancia < 40)
     {
-        return "(dash 35 " + datos.ball.balon_direccion + ")";
+        dash(comando, 35, datos.ball.balon_direccion);
+        return true;
     }
 
     // Somos cualquier jugador y la distancia al balon >25
-    if (datos.jugador.jugador_numero != "1" && stod(datos.ball.balon_distancia) >= 40)
+    if (datos.jugador.jugador_numero != 1 && datos.ball.balon_distancia >= 40)
     {
-        return "(dash 55 " + datos.ball.balon_direccion + ")";
+        dash(comando, 55, datos.ball.balon_direccion);
+        return true;
     }
 
     // Somos portero y nos atacan con el balon, salimos
-    if (datos.jugador.jugador_numero == "1" && stod(datos.ball.balon_distancia) > 2 && stod(datos.ball.balon_distancia) <= 4)
+    if (datos.jugador.jugador_numero == 1 && datos.ball.balon_distancia > 2 && datos.ball.balon_distancia <= 4)
     {
-        return "(dash 10 " + datos.ball.balon_direccion + ")";
+        dash(comando, 10, datos.ball.balon_direccion);
+        return true;
     }
-    return "0";
+    return false;
 }
 
 /**
  * @brief Genera comando de disparo a portería
  *
  * @param datos Estructura de datos del juego
- * @return Comando de disparo con ángulo aleatorio
+ * @param comando Salida: comando de disparo con ángulo aleatorio
  */
-string disparo(Game_data &datos)
+void disparo(Game_data &datos, Comando &comando)
 {
-    float angulo = stof(datos.porteria.centro_direccion);
+    float angulo = datos.porteria.centro_direccion;
 
     // Añade variación aleatoria al disparo
     if (rand() % 2 == 0)
@@ -578,7 +664,7 @@ string disparo(Game_data &datos)
     else
         angulo -= (rand() % 11);  // Desvío a la izquierda
 
-    return "(kick 100 " + to_string(angulo) + ")";
+    kick(comando, 100, angulo, 6);  // 6 decimales, como std::to_string
 }
 
 /**
@@ -589,250 +675,261 @@ string disparo(Game_data &datos)
  * @param datos Estructura de datos del juego
  * @return Comando a enviar al servidor
  */
-string sendMessage(Game_data &datos)
+void sendMessage(Game_data &datos, Comando &comando)
 {
     jugador_cerca_pase(datos);
 
-    string resultado;
-
     // 1. POSICIONAMIENTO INICIAL
     // Inicio de posiciones
-    bool checkStart = (datos.evento.find("goal_l") != -1 || datos.evento.find("goal_r") != -1 ||
-                       datos.evento.find("half_time") != -1 || datos.evento.find("extra_half_time") != -1) ||
-                      datos.evento.find("before_kick_off") != -1;
-
-    if (checkStart)
+    // (el saque de centro tras gol o descanso lo marca la transición del evento)
+    switch (datos.evento.modo)
     {
-        resultado = posicion_inicial(datos);
-        if ((datos.evento.find("goal_l") != -1 && datos.lado_campo == "r") || (datos.evento.find("goal_r") != -1 && datos.lado_campo == "l"))
-        {
-            datos.flag_kick_off = true;
-        }
-        else if (datos.evento.find("half_time") != -1 || datos.evento.find("extra_half_time") != -1)
-        {
-            datos.flag_kick_off = true;
-        }
-        return resultado;
+    case ModoJuego::Goal:
+    case ModoJuego::HalfTime:
+    case ModoJuego::ExtraHalfTime:
+    case ModoJuego::BeforeKickOff:
+        posicion_inicial(datos, comando);
+        return;
+    default:
+        break;
     }
 
     // 2. BÚSQUEDA DEL BALÓN
-    // Si no vemos balon giramos mucho
+    // Si no vemos balon giramos hacia donde deberia estar, o mucho si no lo sabemos
     if (!datos.ball.veo_balon)
     {
-        return "(turn 70)";
+        if (!girar_hacia_balon_previsto(datos, comando))
+            turn(comando, 70);
+        return;
     }
 
     // si vemos mal el balon giramos poco
-    if (abs(stod(datos.ball.balon_direccion)) > 10) // BALON A LA DERECHA, GIRA DERECHA
+    if (abs(datos.ball.balon_direccion) > 10) // BALON A LA DERECHA, GIRA DERECHA
     {
-        return "(turn " + datos.ball.balon_direccion + ")";
+        turn(comando, datos.ball.balon_direccion);
+        return;
     }
 
     // 3. SAQUES ESPECIALES
     // FALTAS
     // Hay saque de balon nuestro (kisk_off_side_l y somos l)
-    if ((datos.evento == "kick_off_l" && datos.jugador.lado_campo == "l") ||
-        (datos.evento == "kick_off_r" && datos.jugador.lado_campo == "r"))
+    if (datos.evento.es(ModoJuego::KickOff, datos.jugador.lado_campo))
     {
         if (tengo_balon(datos))
-            return "(kick 100 70)";
+        {
+            kick(comando, 100, 70);
+            return;
+        }
     }
 
     // CORNERS
-    bool DelanterosCorner = (datos.jugador.jugador_numero == "11" || datos.jugador.jugador_numero == "10" || datos.jugador.jugador_numero == "9");
-    if ((datos.evento.find("indirect_free_kick_l") != -1 && datos.jugador.lado_campo == "l" && DelanterosCorner) ||
-        (datos.evento.find("indirect_free_kick_r") != -1 && datos.jugador.lado_campo == "r" && DelanterosCorner) ||
-        (datos.evento.find("corner_kick_l") != -1 && datos.jugador.lado_campo == "l" && DelanterosCorner) ||
-        (datos.evento.find("corner_kick_r") != -1 && datos.jugador.lado_campo == "r" && DelanterosCorner))
+    bool DelanterosCorner = (datos.jugador.jugador_numero == 11 || datos.jugador.jugador_numero == 10 || datos.jugador.jugador_numero == 9);
+    bool saqueNuestro = datos.evento.es(ModoJuego::IndirectFreeKick, datos.jugador.lado_campo) ||
+                        datos.evento.es(ModoJuego::CornerKick, datos.jugador.lado_campo);
+    if (saqueNuestro && DelanterosCorner)
     {
         if (!tengo_balon(datos))
-            return "(dash 100 " + datos.ball.balon_direccion + ")";
-        else if (tengo_balon(datos))
-            if(datos.porteria.veo_porteria_contraria)
-            {
-                resultado = disparo(datos);
-                return resultado;
-            }
-            else
-            {
-                resultado = pase(datos);
-            }
-        if (resultado == "(kick 10 130)")
         {
-            return "(kick 70 120)";
+            dash(comando, 100, datos.ball.balon_direccion);
+            return;
+        }
+        if(datos.porteria.veo_porteria_contraria)
+        {
+            disparo(datos, comando);
+            return;
+        }
+        pase(datos, comando);
+        if (comando.texto() == "(kick 10 130)")
+        {
+            kick(comando, 70, 120);
         }
-        return resultado;
+        return;
     }
 
     // Si somos el 11 y hay penaltie
-    if (datos.jugador.jugador_numero == "11" && ((datos.evento.find("penalty_kick_l") != -1) && datos.lado_campo == "l" ||
-                                                 (datos.evento.find("penalty_kick_r") != -1) && datos.lado_campo == "r"))
+    if (datos.jugador.jugador_numero == 11 && datos.evento.es(ModoJuego::PenaltyKick, datos.lado_campo))
     {
         if (tengo_balon(datos))
         {
-            resultado = disparo(datos);
-            return resultado;
+            disparo(datos, comando);
+            return;
         }
     }
 
     // Si somos el portero y hay saque de porteria (d<1)
-    bool saquePortero = (datos.evento.find("free_kick_") != -1 && datos.jugador.jugador_numero == "1" && stod(datos.ball.balon_distancia) < 1);
+    ModoJuego modo = datos.evento.modo;
+    bool tiroLibre = modo == ModoJuego::FreeKick || modo == ModoJuego::IndirectFreeKick || modo == ModoJuego::FreeKickFault;
+    bool saquePortero = (tiroLibre && datos.jugador.jugador_numero == 1 && datos.ball.balon_distancia < 1);
     if (saquePortero)
     {
-        resultado = pase(datos);
-        if (resultado == "(kick 10 130)")
+        pase(datos, comando);
+        if (comando.texto() == "(kick 10 130)")
         {
-            resultado = "(kick 100 10)";
-            return resultado;
+            kick(comando, 100, 10);
         }
-        return resultado;
+        return;
     }
 
     // 4. COMPORTAMIENTO EN ÁREA ASIGNADA
 
     if (comprobar_area(datos) || voy_balon(datos))
     {
-        resultado = ataque(datos);
-        if (resultado != "0")
+        if (ataque(datos, comando))
         {
-            return resultado;
+            return;
         }
     }
     else
     {
-        if (datos.jugador.jugador_numero == "1")
+        if (datos.jugador.jugador_numero == 1)
         {
-            return "";
+            comando.limpiar();
+            return;
         }
         else
         {
             // Mejor tener juego agresivo a bugs por ir hacia atras
-            return "(dash 20 180)";
+            dash(comando, 20, 180);
+            return;
         }
     }
 
     // 5. COMPORTAMIENTO DEL PORTERO
 
-    // if (datos.jugador.saque_puerta && datos.jugador.jugador_numero == "1" && stod(datos.ball.balon_distancia) < 1)
-    if(datos.jugador.jugador_numero == "1" && stod(datos.ball.balon_distancia) <= 2 && stod(datos.ball.balon_distancia) >= 0.5)
+    // if (datos.jugador.saque_puerta && datos.jugador.jugador_numero == 1 && datos.ball.balon_distancia < 1)
+    if(datos.jugador.jugador_numero == 1 && datos.ball.balon_distancia <= 2 && datos.ball.balon_distancia >= 0.5)
     {
-        return "(catch " + datos.ball.balon_direccion + ")";
+        catch_(comando, datos.ball.balon_direccion);
+        return;
     }
 
-    if (datos.jugador.jugador_numero == "1" && stod(datos.ball.balon_distancia) < 0.5)
+    if (datos.jugador.jugador_numero == 1 && datos.ball.balon_distancia < 0.5)
     {
         // datos.jugador.saque_puerta = false;
-        if (datos.jugadorCerca.hayJugador && stof(datos.jugadorCerca.distancia) > 10 && !datos.jugadores_vistos.veo_equipo_contrario)
+        if (datos.jugadorCerca.hayJugador && datos.jugadorCerca.distancia > 10 && !datos.jugadores_vistos.veo_equipo_contrario)
         {
-            resultado = pase(datos);
-            if (resultado == "(kick 10 130)")
+            pase(datos, comando);
+            if (comando.texto() == "(kick 10 130)")
             {
                 if (datos.porteria.veo_porteria_propia)
                 {
-                    return "(kick 100 120)";
+                    kick(comando, 100, 120);
                 }
                 else
                 {
-                    return "(kick 100 20)";
+                    kick(comando, 100, 20);
                 }
             }
-            return resultado;
+            return;
         }
         if (datos.porteria.veo_porteria_propia)
         {
-            return "(kick 100 120)";
+            kick(comando, 100, 120);
+            return;
         }
         else
         {
-            return "(kick 100 40)";
+            kick(comando, 100, 40);
+            return;
         }
     }
 
 
     // 6. DISPARO A PORTERÍA
     // Si podemos TIRAR A PORTERIA
-    if (stod(datos.ball.balon_distancia) < 1 && stod(datos.porteria.centro_distancia) <= 38)
+    if (datos.ball.balon_distancia < 1 && datos.porteria.centro_distancia <= 38)
     {
-        resultado = disparo(datos);
-        return resultado;
+        disparo(datos, comando);
+        return;
     }
 
     // 7. PASE CON POSESIÓN
     // Si TENEMOS BALON, valoramos distintas opciones
-    if (stod(datos.ball.balon_distancia) < 1)
+    if (datos.ball.balon_distancia < 1)
     {
         jugador_cerca_pase(datos);
         // Si no somos delanteros y vemos a compañero
-        bool Delantero = (datos.jugador.jugador_numero == "11" || datos.jugador.jugador_numero == "10");
+        bool Delantero = (datos.jugador.jugador_numero == 11 || datos.jugador.jugador_numero == 10);
 
         // Comportamiento defensas
-        bool defensa = (datos.jugador.jugador_numero == "2" || datos.jugador.jugador_numero == "3" || datos.jugador.jugador_numero == "4" || datos.jugador.jugador_numero == "5");
-        if (defensa && !datos.porteria.veo_porteria_propia && datos.jugadorCerca.hayJugador && stof(datos.jugadorCerca.distancia) < 20)
+        bool defensa = (datos.jugador.jugador_numero == 2 || datos.jugador.jugador_numero == 3 || datos.jugador.jugador_numero == 4 || datos.jugador.jugador_numero == 5);
+        if (defensa && !datos.porteria.veo_porteria_propia && datos.jugadorCerca.hayJugador && datos.jugadorCerca.distancia < 20)
         {
             if (datos.porteria.veo_porteria_contraria)
             {
                 int direccion;
                 if((direccion = rand() % 3) == 0)
-                    return "(kick 100 " + datos.porteria.centro_direccion + ")";
+                    kick(comando, 100, datos.porteria.centro_direccion);
                 else if( direccion == 1)
-                    return "(kick 100 " + datos.porteria.palo_abajo_direccion + ")";
+                    kick(comando, 100, datos.porteria.palo_abajo_direccion);
                 else
-                    return "(kick 100 " + datos.porteria.palo_arriba_direccion + ")";
+                    kick(comando, 100, datos.porteria.palo_arriba_direccion);
+                return;
             }
             else
             {
-                return "(kick 100 " + datos.ball.balon_direccion + ")";
+                kick(comando, 100, datos.ball.balon_direccion);
+                return;
             }
         }
-        else if (datos.jugadorCerca.hayJugador && stof(datos.jugadorCerca.distancia) > 15)
+        else if (datos.jugadorCerca.hayJugador && datos.jugadorCerca.distancia > 15)
         {
-            resultado = pase(datos);
-            return resultado;
+            pase(datos, comando);
+            return;
         }
 
         if (!Delantero && datos.jugadorCerca.hayJugador)
         {
-            resultado = pase(datos);
-            return resultado;
+            pase(datos, comando);
+            return;
         }
-        if (datos.porteria.veo_porteria_contraria && datos.jugador.jugador_numero != "1")
+        if (datos.porteria.veo_porteria_contraria && datos.jugador.jugador_numero != 1)
         {
-            return "(kick 25 " + datos.porteria.centro_direccion + ")";
+            kick(comando, 25, datos.porteria.centro_direccion);
+            return;
         }
 
-        if (datos.jugador.jugador_numero != "1")
+        if (datos.jugador.jugador_numero != 1)
         {
-            if (datos.evento.find("kick_in_") != -1 || datos.evento.find("corner_kick_") != -1)
+            if (datos.evento.modo == ModoJuego::KickIn || datos.evento.modo == ModoJuego::CornerKick)
             {
                 if (datos.jugadorCerca.hayJugador)
                 {
-                    resultado = pase(datos);
-                    return resultado;
+                    pase(datos, comando);
+                    return;
                 }
                 else
                 {
-                    return ("(kick 60 180)");
+                    kick(comando, 60, 180);
+                    return;
                 }
             } // REGATE
-            if (datos.lado_campo == "l")
-                return "(kick 10 -70)";
+            if (datos.lado_campo == Lado::Izquierdo)
+            {
+                kick(comando, 10, -70);
+                return;
+            }
             else
             {
-                return "(kick 10 70)";
+                kick(comando, 10, 70);
+                return;
             }
         }
     }
 
-    if (datos.jugador.jugador_numero == "1")
+    if (datos.jugador.jugador_numero == 1)
     {
-        return "";
+        comando.limpiar();
+        return;
     }
 
     // 8. COMPORTAMIENTO POR DEFECTO
     if (tengo_balon(datos))
     {
-        return "(kick 20" + datos.porteria.centro_direccion + ")";
+        kick(comando, 20, datos.porteria.centro_direccion);
+        return;
     }
 
-    return "(dash 1 " + datos.ball.balon_direccion + ")";
+    dash(comando, 1, datos.ball.balon_direccion);
+    return;
 }
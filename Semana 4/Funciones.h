@@ -2,46 +2,60 @@
 #define FUNCIONES_H
 
 #include <string>
+#include <string_view>
 #include <MinimalSocket/udp/UdpSocket.h>
 #include <unistd.h>
 
+#include "comandos.h"
 #include "structs.h"
+#include "utilities.h"
+#include "percepcion.h"
 
 using namespace std;
 
-string posicion_inicial(Game_data &datos);
+void posicion_inicial(Game_data &datos, Comando &comando);
 
 void sendInitialMoveMessage(const string &str, MinimalSocket::udp::Udp<true> &udp_socket,
                      MinimalSocket::Address const &recep, Game_data &datos);
 
+//procesa el mensaje (init l 2 ...) y escribe el comando (move x y) inicial
+void procesar_init(string_view str, Game_data &datos, Comando &comando);
+
 
 //gestiona el mensaje de ball ((b) 12 13) y guarda las variables direccion y distacia 
-//y tiene un flag para saber si tiene el balon o no
-Game_data handle_ball(string const &message, Game_data &datos);
+//y tiene un flag para saber si tiene el balon o no (actualiza datos en su sitio)
+EstadoPercepcion handle_ball(ObservacionSee const &observacion, Game_data &datos);
 
 //gestiona el mensaje de porteria y guarda las variables direccion y distacia de ciertas partes de la porteria
-//y tiene un flag para saber si veo la porteria contraria o no
-Game_data handle_porteria(string const &message, Game_data &datos);
+//y tiene un flag para saber si veo la porteria contraria o no (actualiza datos en su sitio)
+EstadoPercepcion handle_porteria(ObservacionSee const &observacion, Game_data &datos);
 
-//gestiona el mensaje de jugadores del mismo equipo y guarda las variables direccion y distacia en un vector de un vector de string
-//y tiene un flag para saber si veo jugadores o no
-Game_data handle_jugadores_vistos(string const &message, Game_data &datos);
+//gestiona los jugadores vistos y guarda direccion, distancia, dorsal y equipo en el almacen de jugadores
+//y tiene un flag para saber si veo jugadores o no (actualiza datos en su sitio)
+EstadoPercepcion handle_jugadores_vistos(ObservacionSee const &observacion, Game_data &datos);
 
 bool tengo_balon(Game_data const &datos);
 
+//gira el cuerpo hacia donde el filtro predice el balon; false si no hay prediccion fiable
+bool girar_hacia_balon_previsto(Game_data const &datos, Comando &comando);
+
 //es true cuando hay un jugador mas cerca que yo del balon
 void jugador_cerca_pase(Game_data &datos);
 
 bool voy_balon(Game_data &datos);
 
 //lo que hace cuando esta lejos de la porteria
-string pase(Game_data const &datos);
+void pase(Game_data &datos, Comando &comando);
+
+//traduce un evento del arbitro (kick_off_l, goal_r_1, play_on...) a modo de juego y lado
+EventoArbitro decodificar_evento_arbitro(string_view texto);
 
-void send_message_funtion(string const &mensaje, Game_data &datos);
+//actualiza el estado con un mensaje ya tokenizado (hear) y su observacion decodificada (see)
+void send_message_funtion(ArbolSexp const &arbol, ObservacionSee const &observacion, Game_data &datos);
 
 string funcionEnviar(Game_data &datos);
-string ataque(Game_data &datos);
-string disparo(Game_data &datos);
-string sendMessage(Game_data &datos);
+bool ataque(Game_data &datos, Comando &comando);
+void disparo(Game_data &datos, Comando &comando);
+void sendMessage(Game_data &datos, Comando &comando);
 
 #endif
@@ -0,0 +1,388 @@
+/**
+ * @file agente.cpp
+ * @brief Implementación del runtime de agente
+ *
+ * Contiene la gestión del socket UDP de cada jugador (POSIX, no bloqueante,
+ * apto para multiplexar con epoll) y el paso percepción-decisión-acción
+ * que antes vivía dentro del bucle de main.cpp.
+ */
+
+#include "agente.h"
+#include "Funciones.h"
+#include "AbsPos.h"
+#include "balon.h"
+#include "odometria.h"
+#include "mundo.h"
+#include "numeros.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+/**
+ * @brief Abre el socket UDP del agente y prepara su estado inicial
+ *
+ * @param agente Agente a preparar
+ * @param nombre_equipo Nombre del equipo
+ * @param puerto Puerto local al que se liga el socket
+ * @param host IP del servidor RCSS
+ * @param puerto_servidor Puerto del servidor RCSS
+ * @return true si el socket se ha abierto correctamente
+ */
+bool abrir_agente(Agente &agente, string const &nombre_equipo, uint16_t puerto,
+                  string const &host, uint16_t puerto_servidor)
+{
+    agente.datos.nombre_equipo = nombre_equipo;
+    inicializacion_flags(agente.flags);
+
+    agente.servidor = {};
+    agente.servidor.sin_family = AF_INET;
+    agente.servidor.sin_port = htons(puerto_servidor);
+    if (inet_pton(AF_INET, host.c_str(), &agente.servidor.sin_addr) != 1)
+        return false;
+
+    agente.socket_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (agente.socket_fd < 0)
+        return false;
+
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(puerto);
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(agente.socket_fd, reinterpret_cast<sockaddr *>(&local), sizeof(local)) < 0)
+    {
+        cerrar_agente(agente);
+        return false;
+    }
+
+    // Marca de tiempo del kernel en cada datagrama, para estimar la fase del ciclo
+    int activar = 1;
+    setsockopt(agente.socket_fd, SOL_SOCKET, SO_TIMESTAMPNS, &activar, sizeof(activar));
+
+    agente.temporizador_fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (agente.temporizador_fd < 0)
+    {
+        cerrar_agente(agente);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Activa la grabación del tráfico si se ha definido RCSS_REGISTRO
+ *
+ * @param agente Agente a grabar
+ * @param puerto Puerto local del agente
+ */
+void activar_grabacion(Agente &agente, uint16_t puerto)
+{
+    const char *directorio = getenv("RCSS_REGISTRO");
+    if (directorio == nullptr || *directorio == '\0')
+        return;
+
+    string ruta = string(directorio) + "/jugador_" + to_string(puerto) + ".rlog";
+    if (!abrir_grabador(agente.grabador, ruta))
+        cout << "No se puede crear el registro " << ruta << endl;
+}
+
+/**
+ * @brief Cierra el socket del agente
+ *
+ * @param agente Agente a cerrar
+ */
+void cerrar_agente(Agente &agente)
+{
+    if (agente.socket_fd >= 0)
+        close(agente.socket_fd);
+    if (agente.temporizador_fd >= 0)
+        close(agente.temporizador_fd);
+    agente.socket_fd = -1;
+    agente.temporizador_fd = -1;
+    cerrar_grabador(agente.grabador);
+}
+
+/**
+ * @brief Envía un comando al servidor
+ *
+ * @param agente Agente emisor
+ * @param comando Bytes del comando en formato S-expression
+ * @return true si el envío se ha realizado
+ */
+bool enviar_comando(Agente &agente, span<const char> comando)
+{
+    grabar(agente.grabador, Sentido::Enviado, ahora_ns(), string_view(comando.data(), comando.size()));
+    ssize_t enviados = sendto(agente.socket_fd, comando.data(), comando.size(), 0,
+                              reinterpret_cast<sockaddr const *>(&agente.servidor), sizeof(agente.servidor));
+    return enviados == static_cast<ssize_t>(comando.size());
+}
+
+/**
+ * @brief Envía el mensaje (init ...) al servidor
+ *
+ * @param agente Agente que se conecta
+ * @return true si el envío se ha realizado
+ */
+bool enviar_init(Agente &agente)
+{
+    string init_msg;
+    if (agente.soy_portero)
+        init_msg = "(init " + agente.datos.nombre_equipo + " (version 19) (goalie))";
+    else
+        init_msg = "(init " + agente.datos.nombre_equipo + " (version 19))";
+    return enviar_comando(agente, init_msg);
+}
+
+/**
+ * @brief Indica si un mensaje es de percepción visual
+ *
+ * @param mensaje Mensaje recibido
+ * @return true si empieza por "(see "
+ */
+static bool es_see(string_view mensaje)
+{
+    return mensaje.starts_with("(see ");
+}
+
+/**
+ * @brief Indica si un mensaje es un sense_body (el primero de cada ciclo)
+ *
+ * @param mensaje Mensaje recibido
+ * @return true si empieza por "(sense_body "
+ */
+static bool es_sense_body(string_view mensaje)
+{
+    return mensaje.starts_with("(sense_body ");
+}
+
+/**
+ * @brief Extrae la marca de tiempo SO_TIMESTAMPNS de un datagrama
+ *
+ * @param cabecera Cabecera del mensaje devuelta por recvmmsg
+ * @return Instante de llegada en ns, o el instante actual si no hay marca
+ */
+static int64_t instante_llegada(msghdr const &cabecera)
+{
+    for (cmsghdr *c = CMSG_FIRSTHDR(&cabecera); c != nullptr; c = CMSG_NXTHDR(const_cast<msghdr *>(&cabecera), c))
+    {
+        if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            timespec ts;
+            memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+            return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+        }
+    }
+    return ahora_ns();
+}
+
+/**
+ * @brief Si el mensaje es un sense_body, alimenta el estimador de fase
+ *
+ * @param agente Agente receptor
+ * @param mensaje Mensaje recibido (ej: "(sense_body 123 (view_mode high normal) ...)")
+ * @param llegada_ns Instante de llegada del datagrama
+ */
+static void registrar_sense_body(Agente &agente, string_view mensaje, int64_t llegada_ns)
+{
+    constexpr string_view prefijo = "(sense_body ";
+    if (!mensaje.starts_with(prefijo))
+        return;
+
+    // (sense_body Tiempo ...): el tiempo acaba en el siguiente espacio o paréntesis
+    string_view campo = mensaje.substr(prefijo.size());
+    campo = campo.substr(0, campo.find_first_of(" ()"));
+    int ciclo{0};
+    if (leer_entero(campo, ciclo) != ErrorNumero::Ninguno)
+        return;
+    registrar_inicio_ciclo(agente.reloj, llegada_ns, ciclo);
+}
+
+/**
+ * @brief Drena todos los datagramas pendientes y los procesa de forma agrupada
+ *
+ * @param agente Agente receptor
+ * @return true si se ha procesado un "see"
+ *
+ * @note Si el lote se llena con un "see" retenido, se copia a buffer_see antes
+ *       de la siguiente lectura, que reutiliza los mismos buffers
+ */
+bool ingerir_pendientes(Agente &agente)
+{
+    mmsghdr cabeceras[TAM_LOTE];
+    iovec vectores[TAM_LOTE];
+    sockaddr_in remitentes[TAM_LOTE];
+    alignas(cmsghdr) char control[TAM_LOTE][CMSG_SPACE(sizeof(timespec))];
+
+    string_view see_retenido;
+    bool see_procesado = false;
+
+    // Analiza el "see" retenido (el más reciente desde el último sense_body)
+    auto procesar_see_retenido = [&]()
+    {
+        if (see_retenido.empty())
+            return;
+        agente.ingesta.see_procesados++;
+        see_procesado |= percibir(agente, see_retenido);
+        see_retenido = {};
+    };
+
+    while (true)
+    {
+        for (int i = 0; i < TAM_LOTE; i++)
+        {
+            vectores[i] = {agente.buffers[i].data(), TAM_MAX_MENSAJE};
+            cabeceras[i] = {};
+            cabeceras[i].msg_hdr.msg_iov = &vectores[i];
+            cabeceras[i].msg_hdr.msg_iovlen = 1;
+            cabeceras[i].msg_hdr.msg_name = &remitentes[i];
+            cabeceras[i].msg_hdr.msg_namelen = sizeof(remitentes[i]);
+            cabeceras[i].msg_hdr.msg_control = control[i];
+            cabeceras[i].msg_hdr.msg_controllen = sizeof(control[i]);
+        }
+
+        int leidos = recvmmsg(agente.socket_fd, cabeceras, TAM_LOTE, MSG_DONTWAIT, nullptr);
+        if (leidos <= 0)
+            break;
+        agente.ingesta.lotes++;
+        agente.ingesta.datagramas += leidos;
+
+        for (int i = 0; i < leidos; i++)
+        {
+            string_view mensaje(agente.buffers[i].data(), cabeceras[i].msg_len);
+            int64_t llegada = instante_llegada(cabeceras[i].msg_hdr);
+            grabar(agente.grabador, Sentido::Recibido, llegada, mensaje);
+            if (es_see(mensaje))
+            {
+                if (!see_retenido.empty())
+                    agente.ingesta.see_descartados++;
+                see_retenido = mensaje;
+                continue;
+            }
+
+            // El servidor responde al init desde un puerto propio para cada jugador
+            if (!agente.inicializado)
+                agente.servidor.sin_port = remitentes[i].sin_port;
+            // Un sense_body abre otro ciclo: el "see" retenido es anterior y se
+            // analiza antes, para no fusionarlo con una odometría ya adelantada
+            if (es_sense_body(mensaje))
+                procesar_see_retenido();
+            registrar_sense_body(agente, mensaje, llegada);
+            percibir(agente, mensaje);
+        }
+
+        if (leidos == TAM_LOTE && !see_retenido.empty() && see_retenido.data() != agente.buffer_see.data())
+        {
+            memcpy(agente.buffer_see.data(), see_retenido.data(), see_retenido.size());
+            see_retenido = string_view(agente.buffer_see.data(), see_retenido.size());
+        }
+
+        // Lote incompleto: el socket ya está vacío
+        if (leidos < TAM_LOTE)
+            break;
+    }
+
+    procesar_see_retenido();
+    return see_procesado;
+}
+
+/**
+ * @brief Fase de PERCEPCIÓN: procesa un mensaje recibido del servidor
+ *
+ * @param agente Agente receptor
+ * @param mensaje Mensaje recibido
+ * @return true si el mensaje era un "see"
+ *
+ * @note La posición absoluta del portero solo se recalcula con el balón cerca
+ */
+bool percibir(Agente &agente, string_view mensaje)
+{
+    try
+    {
+        if (!agente.inicializado)
+        {
+            // Respuesta al init: lado, número y colocación inicial
+            procesar_init(mensaje, agente.datos, agente.comando_pendiente);
+            enviar_comando(agente, agente.comando_pendiente.datos());
+            agente.comando_pendiente.limpiar();
+            agente.inicializado = true;
+            return false;
+        }
+
+        if (!tokenizar(mensaje, agente.arbol))
+            throw runtime_error("mensaje mal formado");
+
+        decodificar_see(agente.arbol, agente.datos.nombre_equipo, agente.observacion);
+        send_message_funtion(agente.arbol, agente.observacion, agente.datos);
+        // Navegación a estima en cada ciclo; la localización la corrige con un "see"
+        SenseBody sense;
+        if (decodificar_sense_body(agente.arbol, sense))
+            actualizar_odometria(sense, agente.datos);                // ODOMETRÍA
+        if (agente.observacion.valida &&
+            (agente.datos.jugador.jugador_numero != 1 || agente.datos.ball.balon_distancia < 5))
+        {
+            crear_matriz_valores_absolutos(agente.observacion, agente.flags); // ABSOLUTOS
+            relative2Abssolute(agente.flags, agente.datos);        // ABSOLUTOS
+        }
+        actualizar_balon(agente.observacion, agente.datos);            // FILTRO DEL BALÓN
+        if (agente.observacion.valida)
+        {
+            proyectar_observaciones(agente.datos);                     // PROYECCIÓN AL CAMPO
+            actualizar_mundo(agente.observacion.tiempo, agente.datos); // MODELO PERSISTENTE
+        }
+    }
+    catch (const std::exception &e)
+    {
+        cout << e.what() << endl;
+    }
+    return es_see(mensaje);
+}
+
+/**
+ * @brief Fases de DECISIÓN y ACCIÓN: genera el comando y lo programa para su plazo
+ *
+ * @param agente Agente que actúa
+ */
+void actuar(Agente &agente)
+{
+    int64_t ahora = ahora_ns();
+    agente.plazo_pendiente = plazo_envio(agente.reloj, ahora);
+    sendMessage(agente.datos, agente.comando_pendiente);
+
+    if (agente.plazo_pendiente <= ahora)
+    {
+        despachar_pendiente(agente);
+        return;
+    }
+
+    // Temporizador absoluto: vence justo en el plazo de envío
+    itimerspec alarma{};
+    alarma.it_value.tv_sec = agente.plazo_pendiente / 1'000'000'000;
+    alarma.it_value.tv_nsec = agente.plazo_pendiente % 1'000'000'000;
+    timerfd_settime(agente.temporizador_fd, TFD_TIMER_ABSTIME, &alarma, nullptr);
+}
+
+/**
+ * @brief Envía el comando pendiente si su plazo ha vencido
+ *
+ * @param agente Agente que despacha
+ */
+void despachar_pendiente(Agente &agente)
+{
+    uint64_t vencimientos;
+    while (read(agente.temporizador_fd, &vencimientos, sizeof(vencimientos)) > 0)
+    {
+    }
+
+    int64_t ahora = ahora_ns();
+    if (agente.comando_pendiente.vacio() || ahora < agente.plazo_pendiente)
+        return;
+
+    enviar_comando(agente, agente.comando_pendiente.datos());
+    registrar_envio(agente.reloj, agente.plazo_pendiente, ahora);
+    aplicar_comando_enviado(agente.comando_pendiente, agente.datos);
+    agente.comando_pendiente.limpiar();
+}
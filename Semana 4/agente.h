@@ -0,0 +1,184 @@
+/**
+ * @file agente.h
+ * @brief Archivo de cabecera del runtime de agente
+ *
+ * Agrupa todo el estado que necesita un jugador (datos del juego, flags de
+ * localización y socket UDP) y expone el paso percepción-decisión-acción
+ * como funciones independientes del bucle de eventos. Así un mismo proceso
+ * puede alojar a los 11 jugadores del equipo sobre un único epoll.
+ */
+
+#ifndef AGENTE_H
+#define AGENTE_H
+
+// Inclusión de dependencias
+#include "comandos.h"
+#include "structs.h"
+#include "sincronizacion.h"
+#include "registro.h"
+#include "utilities.h"
+#include "percepcion.h"
+#include "tabla_flags.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <netinet/in.h>    // sockaddr_in
+
+using namespace std;
+
+/// Tamaño máximo de un datagrama del servidor RCSS (MaxMesg en rcssserver)
+constexpr size_t TAM_MAX_MENSAJE = 8192;
+
+/// Datagramas leídos por cada llamada a recvmmsg
+constexpr int TAM_LOTE = 8;
+
+/**
+ * @brief Contadores de la etapa de ingesta de datagramas
+ */
+struct EstadisticasIngesta
+{
+    uint64_t lotes;             ///< Llamadas a recvmmsg que devolvieron datos
+    uint64_t datagramas;        ///< Datagramas recibidos en total
+    uint64_t see_procesados;    ///< Mensajes "see" analizados (uno por ciclo como máximo)
+    uint64_t see_descartados;   ///< Mensajes "see" antiguos saltados por llegar otro más reciente
+
+    /**
+     * @brief Constructor por defecto
+     */
+    EstadisticasIngesta()
+        : lotes(0), datagramas(0), see_procesados(0), see_descartados(0) {}
+};
+
+/**
+ * @brief Estado completo de un jugador alojado en el runtime
+ */
+struct Agente
+{
+    Game_data datos;                          ///< Estado del juego visto por este jugador
+    FlagsCampo flags;                         ///< Flags para la localización absoluta
+    int socket_fd;                            ///< Socket UDP no bloqueante del jugador
+    int temporizador_fd;                      ///< timerfd que vence en el plazo de envío del comando
+    sockaddr_in servidor;                     ///< Dirección del servidor (puerto actualizado tras el init)
+    bool soy_portero;                         ///< Se conecta con (goalie)
+    bool inicializado;                        ///< Se ha recibido la respuesta al init
+    array<array<char, TAM_MAX_MENSAJE>, TAM_LOTE> buffers; ///< Buffers de recepción fijos de un lote
+    array<char, TAM_MAX_MENSAJE> buffer_see;  ///< Copia del "see" más reciente si el lote se llena
+    ArbolSexp arbol;                          ///< Último mensaje tokenizado (se reutiliza entre mensajes)
+    ObservacionSee observacion;               ///< Objetos del último "see", decodificados una vez por ciclo
+    EstadisticasIngesta ingesta;              ///< Contadores de la etapa de ingesta
+    RelojCiclo reloj;                         ///< Fase estimada del ciclo del servidor
+    Comando comando_pendiente;                ///< Último comando decidido, a la espera de su plazo
+    int64_t plazo_pendiente;                  ///< Instante (ns) en que se debe enviar comando_pendiente
+    Grabador grabador;                        ///< Registro binario del tráfico (desactivado por defecto)
+
+    /**
+     * @brief Constructor por defecto
+     */
+    Agente()
+        : datos(), flags(), socket_fd(-1), temporizador_fd(-1), servidor(),
+        soy_portero(false), inicializado(false), buffers(), buffer_see(), arbol(), observacion(), ingesta(),
+        reloj(), comando_pendiente(), plazo_pendiente(0), grabador() {}
+};
+
+/**
+ * @brief Abre el socket UDP del agente y prepara su estado inicial
+ *
+ * @param agente Agente a preparar
+ * @param nombre_equipo Nombre del equipo
+ * @param puerto Puerto local al que se liga el socket
+ * @param host IP del servidor RCSS
+ * @param puerto_servidor Puerto del servidor RCSS (6000 por defecto)
+ * @return true si el socket se ha abierto correctamente
+ */
+bool abrir_agente(Agente &agente, string const &nombre_equipo, uint16_t puerto,
+                  string const &host, uint16_t puerto_servidor);
+
+/**
+ * @brief Activa la grabación del tráfico si se ha definido RCSS_REGISTRO
+ *
+ * Con la variable de entorno RCSS_REGISTRO=<directorio>, cada jugador graba
+ * su tráfico en <directorio>/jugador_<puerto>.rlog (ver registro.h).
+ *
+ * @param agente Agente a grabar
+ * @param puerto Puerto local del agente (identifica el fichero)
+ */
+void activar_grabacion(Agente &agente, uint16_t puerto);
+
+/**
+ * @brief Cierra el socket del agente
+ *
+ * @param agente Agente a cerrar
+ */
+void cerrar_agente(Agente &agente);
+
+/**
+ * @brief Envía el mensaje (init ...) al servidor
+ *
+ * @param agente Agente que se conecta
+ * @return true si el envío se ha realizado
+ */
+bool enviar_init(Agente &agente);
+
+/**
+ * @brief Envía un comando al servidor
+ *
+ * @param agente Agente emisor
+ * @param comando Bytes del comando en formato S-expression (ej: "(dash 100 0)")
+ * @return true si el envío se ha realizado
+ */
+bool enviar_comando(Agente &agente, span<const char> comando);
+
+/**
+ * @brief Drena todos los datagramas pendientes y los procesa de forma agrupada
+ *
+ * Lee con recvmmsg lotes de hasta TAM_LOTE datagramas en los buffers fijos
+ * del agente hasta vaciar el socket. Los mensajes que no son "see" (hear,
+ * sense_body, init...) se aplican en orden de llegada; de los "see" de un
+ * mismo ciclo solo se analiza el más reciente, justo antes del sense_body del
+ * ciclo siguiente o al final del drenaje, y el resto se cuentan como
+ * descartados.
+ *
+ * @param agente Agente receptor
+ * @return true si se ha procesado un "see" (el agente debe decidir y actuar)
+ */
+bool ingerir_pendientes(Agente &agente);
+
+/**
+ * @brief Fase de PERCEPCIÓN: procesa un mensaje recibido del servidor
+ *
+ * El primer mensaje (respuesta al init) fija lado, número y puerto del
+ * servidor y coloca al jugador en su posición inicial. El resto actualiza
+ * el estado del juego y la posición absoluta.
+ *
+ * @param agente Agente receptor
+ * @param mensaje Mensaje recibido
+ * @return true si el mensaje era un "see" (el agente debe decidir y actuar)
+ */
+bool percibir(Agente &agente, string_view mensaje);
+
+/**
+ * @brief Fases de DECISIÓN y ACCIÓN: genera el comando y lo programa para su plazo
+ *
+ * El comando no se envía al instante: queda pendiente hasta el último momento
+ * seguro del ciclo (plazo_envio) y se arma el temporizador del agente. Si antes
+ * del plazo llega un "see" más reciente, la nueva decisión sustituye a la anterior.
+ * Sin fase estimada todavía, el comando se envía inmediatamente.
+ *
+ * @param agente Agente que actúa
+ */
+void actuar(Agente &agente);
+
+/**
+ * @brief Envía el comando pendiente si su plazo ha vencido
+ *
+ * Se llama cuando el temporizador del agente es legible.
+ *
+ * @param agente Agente que despacha
+ */
+void despachar_pendiente(Agente &agente);
+
+#endif // AGENTE_H
@@ -0,0 +1,302 @@
+/**
+ * @file balon.cpp
+ * @brief Implementación del estimador del balón (filtro de Kalman)
+ */
+
+#include "balon.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// Paso logarítmico con el que el servidor cuantiza la distancia a objetos móviles (quantize_step)
+constexpr float CUANTIZACION_MOVILES = 0.1f;
+
+/// Ruido de aceleración no modelada (rozamientos, choques) en metros/ciclo
+constexpr float RUIDO_ACELERACION = 0.05f;
+
+/// Desviación típica (m/ciclo) de nuestra propia velocidad cuando no hay sense_body del ciclo
+constexpr float RUIDO_VELOCIDAD_PROPIA = 0.3f;
+
+/// Desviación típica (m/ciclo) de nuestra propia velocidad leída del sense_body del ciclo
+constexpr float RUIDO_VELOCIDAD_ODOMETRIA = 0.02f;
+
+/// Umbral de Mahalanobis² (2 grados de libertad, 99.9 %) para aceptar una observación
+constexpr float UMBRAL_INNOVACION = 13.8f;
+
+/// Ciclos máximos que se predicen de una vez; más allá se reinicia la incertidumbre
+constexpr int MAX_CICLOS_PREDICCION = 50;
+
+/// Varianza inicial de la velocidad cuando no se conoce
+constexpr float VARIANZA_VELOCIDAD_INICIAL = VELOCIDAD_MAX_BALON * VELOCIDAD_MAX_BALON;
+
+using Matriz4 = array<array<float, 4>, 4>;
+
+/**
+ * @brief Un paso del modelo: x += v, v *= decay, P = F·P·Fᵀ + Q
+ */
+static void paso_prediccion(FiltroBalon &filtro)
+{
+    array<float, 4> &e = filtro.estado;
+    Matriz4 &P = filtro.covarianza;
+    const float a = DECAIMIENTO_BALON;
+
+    e[0] += e[2];
+    e[1] += e[3];
+    e[2] *= a;
+    e[3] *= a;
+
+    // F·P: filas de posición suman las de velocidad; las de velocidad se escalan
+    Matriz4 FP;
+    for (int j = 0; j < 4; j++)
+    {
+        FP[0][j] = P[0][j] + P[2][j];
+        FP[1][j] = P[1][j] + P[3][j];
+        FP[2][j] = a * P[2][j];
+        FP[3][j] = a * P[3][j];
+    }
+    // (F·P)·Fᵀ: lo mismo por columnas
+    for (int i = 0; i < 4; i++)
+    {
+        P[i][0] = FP[i][0] + FP[i][2];
+        P[i][1] = FP[i][1] + FP[i][3];
+        P[i][2] = a * FP[i][2];
+        P[i][3] = a * FP[i][3];
+    }
+
+    // Ruido: ball_rand proporcional a la velocidad (uniforme, varianza w²/3) y aceleración no modelada
+    float velocidad2 = e[2] * e[2] + e[3] * e[3];
+    float q = RUIDO_BALON * RUIDO_BALON * velocidad2 / 3 + RUIDO_ACELERACION * RUIDO_ACELERACION;
+    P[0][0] += q / 4;
+    P[1][1] += q / 4;
+    P[0][2] += q / 2;
+    P[2][0] += q / 2;
+    P[1][3] += q / 2;
+    P[3][1] += q / 2;
+    P[2][2] += q;
+    P[3][3] += q;
+}
+
+/**
+ * @brief Corrección con una medida de dos componentes del estado (posición o velocidad)
+ *
+ * @param filtro Filtro a corregir
+ * @param k Primera componente medida (0: posición, 2: velocidad)
+ * @param z Medida
+ * @param R Covarianza de la medida (2x2)
+ * @param comprobar Rechazar la medida si la innovación es inverosímil
+ * @return false si se ha rechazado
+ */
+static bool corregir(FiltroBalon &filtro, int k, array<float, 2> const &z, array<array<float, 2>, 2> const &R,
+                     bool comprobar)
+{
+    array<float, 4> &e = filtro.estado;
+    Matriz4 &P = filtro.covarianza;
+
+    float s00 = P[k][k] + R[0][0], s01 = P[k][k + 1] + R[0][1], s11 = P[k + 1][k + 1] + R[1][1];
+    float det = s00 * s11 - s01 * s01;
+    if (!(det > 0))
+        return false;
+    float i00 = s11 / det, i01 = -s01 / det, i11 = s00 / det;
+
+    float y0 = z[0] - e[k], y1 = z[1] - e[k + 1];
+    if (comprobar && y0 * (i00 * y0 + i01 * y1) + y1 * (i01 * y0 + i11 * y1) > UMBRAL_INNOVACION)
+        return false;
+
+    // K = P·Hᵀ·S⁻¹ (4x2); estado += K·y; P -= K·H·P
+    array<array<float, 2>, 4> K;
+    for (int i = 0; i < 4; i++)
+    {
+        K[i][0] = P[i][k] * i00 + P[i][k + 1] * i01;
+        K[i][1] = P[i][k] * i01 + P[i][k + 1] * i11;
+    }
+    for (int i = 0; i < 4; i++)
+        e[i] += K[i][0] * y0 + K[i][1] * y1;
+
+    array<array<float, 4>, 2> HP = {P[k], P[k + 1]};
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            P[i][j] -= K[i][0] * HP[0][j] + K[i][1] * HP[1][j];
+    return true;
+}
+
+/**
+ * @brief Covarianza en el campo de un error radial y uno tangencial
+ *
+ * @param c Coseno de la dirección radial en el campo
+ * @param s Seno de la dirección radial en el campo
+ */
+static array<array<float, 2>, 2> covarianza_polar(float c, float s, float var_radial, float var_tangencial)
+{
+    return {{{c * c * var_radial + s * s * var_tangencial, c * s * (var_radial - var_tangencial)},
+             {c * s * (var_radial - var_tangencial), s * s * var_radial + c * c * var_tangencial}}};
+}
+
+/**
+ * @brief Avanza el filtro hasta un ciclo sin observación
+ *
+ * @param filtro Filtro del balón
+ * @param tiempo Ciclo destino (si es anterior al del filtro no hace nada)
+ */
+void predecir_balon(FiltroBalon &filtro, int tiempo)
+{
+    if (!filtro.inicializado || tiempo <= filtro.tiempo)
+        return;
+
+    int ciclos = tiempo - filtro.tiempo;
+    if (ciclos > MAX_CICLOS_PREDICCION)
+    {
+        // Demasiado tiempo sin verlo: el balón estará parado, pero no se sabe dónde
+        Punto parada = posicion_balon_en(filtro, ciclos);
+        filtro.estado = {parada.x, parada.y, 0, 0};
+        float var = ciclos * RUIDO_ACELERACION * RUIDO_ACELERACION + filtro.covarianza[0][0] + filtro.covarianza[1][1];
+        filtro.covarianza = {};
+        filtro.covarianza[0][0] = filtro.covarianza[1][1] = var;
+        filtro.covarianza[2][2] = filtro.covarianza[3][3] = RUIDO_ACELERACION * RUIDO_ACELERACION;
+    }
+    else
+    {
+        for (int c = 0; c < ciclos; c++)
+            paso_prediccion(filtro);
+    }
+    filtro.tiempo = tiempo;
+}
+
+/**
+ * @brief Predice el filtro hasta el ciclo del "see" y lo corrige si se ve el balón
+ *
+ * La observación polar (distancia, dirección) se pasa al campo con la pose
+ * del jugador. Su error combina la cuantización del servidor (escalón
+ * logarítmico de 0.1 en distancia, grados enteros en dirección) con el error
+ * de la propia pose. El cambio de distancia y de dirección da la velocidad
+ * relativa, a la que se suma la nuestra según la odometría.
+ *
+ * @param observacion Objetos del último "see"
+ * @param datos Estructura con la pose del jugador y el filtro del balón
+ * @return true si el balón se ha observado y fusionado
+ */
+bool actualizar_balon(ObservacionSee const &observacion, Game_data &datos)
+{
+    if (!observacion.valida)
+        return false;
+    FiltroBalon &filtro = datos.ball.filtro;
+    predecir_balon(filtro, observacion.tiempo);
+
+    Player const &jugador = datos.jugador;
+    if (observacion.balon == -1 || jugador.confianza_posicion <= 0 || jugador.orientacion_cuello == 999.0f)
+        return false;
+    ObjetoVisto const &balon = observacion.objetos[observacion.balon];
+    if (balon.num_valores < 2)
+        return false;
+
+    // Posición: la dirección del servidor es horaria y relativa a la vista
+    float d = balon.distancia;
+    float angulo = (jugador.orientacion_cuello - balon.direccion) * static_cast<float>(M_PI / 180);
+    float c = cos(angulo), s = sin(angulo);
+    array<float, 2> posicion = {jugador.x_absoluta + d * c, jugador.y_absoluta + d * s};
+
+    // Error: cuantización (uniforme, w²/12) más la pose (confianza = 1 / (1 + sigma))
+    float error_pose = 1 / jugador.confianza_posicion - 1;
+    float escalon = d * CUANTIZACION_MOVILES;
+    float var_radial = (escalon * escalon + 0.01f) / 12 + error_pose * error_pose;
+    float error_angulo = static_cast<float>(M_PI / 180) * min(jugador.error_orientacion, 90.0f);
+    float var_tangencial = d * d * (static_cast<float>(M_PI / 180 * M_PI / 180) / 12 + error_angulo * error_angulo) +
+                           error_pose * error_pose;
+    auto R_posicion = covarianza_polar(c, s, var_radial, var_tangencial);
+
+    if (!filtro.inicializado)
+    {
+        filtro.inicializado = true;
+        filtro.estado = {posicion[0], posicion[1], 0, 0};
+        filtro.covarianza = {};
+        filtro.covarianza[0][0] = R_posicion[0][0];
+        filtro.covarianza[0][1] = filtro.covarianza[1][0] = R_posicion[0][1];
+        filtro.covarianza[1][1] = R_posicion[1][1];
+        filtro.covarianza[2][2] = filtro.covarianza[3][3] = VARIANZA_VELOCIDAD_INICIAL;
+    }
+    else if (!corregir(filtro, 0, posicion, R_posicion, true))
+    {
+        // Innovación inverosímil (alguien lo ha golpeado): se reinicia en la observación
+        filtro.estado = {posicion[0], posicion[1], 0, 0};
+        filtro.covarianza = {};
+        filtro.covarianza[0][0] = R_posicion[0][0];
+        filtro.covarianza[0][1] = filtro.covarianza[1][0] = R_posicion[0][1];
+        filtro.covarianza[1][1] = R_posicion[1][1];
+        filtro.covarianza[2][2] = filtro.covarianza[3][3] = VARIANZA_VELOCIDAD_INICIAL;
+    }
+    filtro.tiempo = observacion.tiempo;
+    filtro.ultima_vista = observacion.tiempo;
+
+    // Velocidad: componente radial (cambio de distancia) y tangencial (cambio de dirección)
+    if (balon.num_valores >= 4)
+    {
+        float v_radial = balon.cambio_distancia;
+        float v_tangencial = -d * balon.cambio_direccion * static_cast<float>(M_PI / 180);
+        array<float, 2> velocidad = {v_radial * c - v_tangencial * s, v_radial * s + v_tangencial * c};
+        float var_propia = RUIDO_VELOCIDAD_PROPIA * RUIDO_VELOCIDAD_PROPIA;
+        if (datos.odometria.tiempo == observacion.tiempo)
+        {
+            velocidad[0] += datos.odometria.vx;
+            velocidad[1] += datos.odometria.vy;
+            var_propia = RUIDO_VELOCIDAD_ODOMETRIA * RUIDO_VELOCIDAD_ODOMETRIA;
+        }
+        float paso_angulo = d * static_cast<float>(M_PI / 180) * 0.1f;
+        auto R_velocidad = covarianza_polar(c, s, 0.01f / 12 + var_propia, paso_angulo * paso_angulo / 12 + var_propia);
+        corregir(filtro, 2, velocidad, R_velocidad, false);
+    }
+
+    // Nunca más rápido de lo que permite el servidor
+    float velocidad = hypot(filtro.estado[2], filtro.estado[3]);
+    if (velocidad > VELOCIDAD_MAX_BALON)
+    {
+        filtro.estado[2] *= VELOCIDAD_MAX_BALON / velocidad;
+        filtro.estado[3] *= VELOCIDAD_MAX_BALON / velocidad;
+    }
+    return true;
+}
+
+/**
+ * @brief Tiene en cuenta un kick propio: la velocidad del balón pasa a ser incierta
+ *
+ * La aceleración real depende de la distancia y el ángulo al balón, así que
+ * solo se amplía la incertidumbre de la velocidad en la medida de la potencia.
+ *
+ * @param filtro Filtro del balón
+ * @param potencia Potencia del kick enviado
+ */
+void registrar_kick(FiltroBalon &filtro, float potencia)
+{
+    if (!filtro.inicializado)
+        return;
+    float aceleracion = abs(potencia) * TASA_POTENCIA_KICK;
+    filtro.covarianza[2][2] += aceleracion * aceleracion;
+    filtro.covarianza[3][3] += aceleracion * aceleracion;
+}
+
+/**
+ * @brief Posición prevista del balón unos ciclos después del estado del filtro, en O(1)
+ *
+ * @param filtro Filtro del balón (inicializado)
+ * @param ciclos Ciclos hacia delante (0 = estado actual)
+ * @return Posición prevista en el campo
+ */
+Punto posicion_balon_en(FiltroBalon const &filtro, int ciclos)
+{
+    float recorrido = (1 - pow(DECAIMIENTO_BALON, static_cast<float>(max(ciclos, 0)))) / (1 - DECAIMIENTO_BALON);
+    return {filtro.estado[0] + filtro.estado[2] * recorrido, filtro.estado[1] + filtro.estado[3] * recorrido};
+}
+
+/**
+ * @brief Desviación típica (m) de la posición estimada del balón
+ */
+float error_posicion_balon(FiltroBalon const &filtro)
+{
+    return sqrt(filtro.covarianza[0][0] + filtro.covarianza[1][1]);
+}
+
+/**
+ * @brief Indica si la estimación es lo bastante buena para orientarse hacia el balón
+ */
+bool balon_localizado(FiltroBalon const &filtro)
+{
+    return filtro.inicializado && error_posicion_balon(filtro) < ERROR_MAX_BALON;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file balon.h
+ * @brief Archivo de cabecera del estimador del balón (filtro de Kalman)
+ *
+ * Sigue el balón en coordenadas del campo con un modelo de velocidad
+ * constante que decae como en el servidor (ball_decay). Cada "see" se predice
+ * hasta su ciclo y, si el balón aparece, se corrige con su posición y con el
+ * cambio de distancia y dirección que envía el servidor. Cuando no se ve, la
+ * predicción sigue disponible, así que la decisión puede girarse hacia donde
+ * debe estar en lugar de buscarlo a ciegas.
+ */
+
+#ifndef BALON_H
+#define BALON_H
+
+// Inclusión de dependencias
+#include "structs.h"
+#include "percepcion.h"
+
+using namespace std;
+
+/// Decaimiento de la velocidad del balón por ciclo (ball_decay del servidor)
+constexpr float DECAIMIENTO_BALON = 0.94f;
+
+/// Ruido de movimiento del balón (ball_rand del servidor)
+constexpr float RUIDO_BALON = 0.05f;
+
+/// Velocidad máxima del balón en metros/ciclo (ball_speed_max del servidor)
+constexpr float VELOCIDAD_MAX_BALON = 3.0f;
+
+/// Fuerza de un kick de potencia 1 (kick_power_rate del servidor)
+constexpr float TASA_POTENCIA_KICK = 0.027f;
+
+/// Error de posición (m) por encima del cual la estimación no sirve para orientarse
+constexpr float ERROR_MAX_BALON = 5.0f;
+
+/**
+ * @brief Avanza el filtro hasta un ciclo sin observación
+ *
+ * @param filtro Filtro del balón
+ * @param tiempo Ciclo destino (si es anterior al del filtro no hace nada)
+ */
+void predecir_balon(FiltroBalon &filtro, int tiempo);
+
+/**
+ * @brief Predice el filtro hasta el ciclo del "see" y lo corrige si se ve el balón
+ *
+ * Necesita la pose del jugador (relative2Abssolute) para pasar la observación
+ * a coordenadas del campo; sin pose solo predice.
+ *
+ * @param observacion Objetos del último "see"
+ * @param datos Estructura con la pose del jugador y el filtro del balón
+ * @return true si el balón se ha observado y fusionado
+ */
+bool actualizar_balon(ObservacionSee const &observacion, Game_data &datos);
+
+/**
+ * @brief Tiene en cuenta un kick propio: la velocidad del balón pasa a ser incierta
+ *
+ * @param filtro Filtro del balón
+ * @param potencia Potencia del kick enviado
+ */
+void registrar_kick(FiltroBalon &filtro, float potencia);
+
+/**
+ * @brief Posición prevista del balón unos ciclos después del estado del filtro, en O(1)
+ *
+ * Suma cerrada de la serie geométrica: p + v·(1 - decay^n) / (1 - decay).
+ *
+ * @param filtro Filtro del balón (inicializado)
+ * @param ciclos Ciclos hacia delante (0 = estado actual)
+ * @return Posición prevista en el campo
+ */
+Punto posicion_balon_en(FiltroBalon const &filtro, int ciclos);
+
+/**
+ * @brief Desviación típica (m) de la posición estimada del balón
+ */
+float error_posicion_balon(FiltroBalon const &filtro);
+
+/**
+ * @brief Indica si la estimación es lo bastante buena para orientarse hacia el balón
+ */
+bool balon_localizado(FiltroBalon const &filtro);
+
+#endif // BALON_H
@@ -0,0 +1,344 @@
+/**
+ * @file bench.cpp
+ * @brief Benchmark sin interfaz del ciclo completo del agente
+ *
+ * Carga uno o varios registros binarios (grabados con RCSS_REGISTRO) y pasa
+ * cada mensaje recibido por las mismas etapas que percibir() y actuar():
+ * parseo (tokenizar, decodificar_see y send_message_funtion), odometría
+ * (decodificar_sense_body y actualizar_odometria), localización
+ * (crear_matriz_valores_absolutos y relative2Abssolute), filtro del balón
+ * (actualizar_balon), proyección (proyectar_observaciones), modelo de
+ * jugadores (actualizar_mundo) y decisión (sendMessage). Por etapa muestra la
+ * latencia p50/p99/p999, las reservas de memoria por ciclo (número y bytes)
+ * y los bytes de Game_data copiados por ciclo, y en total los mensajes por
+ * segundo y qué parte de las localizaciones supera su presupuesto. Sirve de
+ * referencia para comparar cambios.
+ *
+ * Se compila con RCSS_CONTAR_COPIAS para que Game_data cuente sus copias.
+ *
+ * Uso: ./bench_agent <fichero.rlog>... [--repeticiones N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <new>
+#include <vector>
+
+#include "agente.h"
+#include "AbsPos.h"
+#include "balon.h"
+#include "odometria.h"
+#include "mundo.h"
+#include "Funciones.h"
+#include "numeros.h"
+#include "registro.h"
+
+#ifndef RCSS_CONTAR_COPIAS
+#error "bench_agent se compila con RCSS_CONTAR_COPIAS (ver CMakeLists.txt)"
+#endif
+
+// ======================================================
+// CONTADOR DE RESERVAS
+// ======================================================
+static uint64_t reservas = 0;
+static uint64_t bytes_reservados = 0;
+
+void *operator new(size_t tam)
+{
+    reservas++;
+    bytes_reservados += tam;
+    if (void *p = malloc(tam ? tam : 1))
+        return p;
+    throw bad_alloc();
+}
+
+void *operator new[](size_t tam)
+{
+    return operator new(tam);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+// ======================================================
+// MEDIDAS POR ETAPA
+// ======================================================
+enum Etapa
+{
+    PARSEO,
+    ODOMETRIA,
+    LOCALIZACION,
+    BALON,
+    PROYECCION,
+    MUNDO,
+    DECISION,
+    TOTAL,
+    NUM_ETAPAS
+};
+
+static const char *NOMBRE_ETAPA[NUM_ETAPAS] = {"parseo", "odometria", "localizacion", "balon", "proyeccion", "mundo", "decision", "total"};
+
+/**
+ * @brief Contadores de memoria: reservas, bytes reservados y bytes de Game_data copiados
+ */
+struct Contadores
+{
+    uint64_t reservas = 0;
+    uint64_t bytes = 0;
+    uint64_t copiados = 0;
+
+    Contadores &operator+=(Contadores const &otros)
+    {
+        reservas += otros.reservas;
+        bytes += otros.bytes;
+        copiados += otros.copiados;
+        return *this;
+    }
+};
+
+static Contadores leer_contadores()
+{
+    return {reservas, bytes_reservados, bytes_copiados};
+}
+
+/**
+ * @brief Latencias (ns) y contadores de memoria acumulados de una etapa
+ */
+struct MedidaEtapa
+{
+    vector<int64_t> latencias;
+    Contadores contadores;
+};
+
+/**
+ * @brief Cronómetro de una etapa: mide tiempo y contadores entre inicio y fin
+ */
+struct Cronometro
+{
+    chrono::steady_clock::time_point inicio;
+    Contadores contadores_inicio;
+};
+
+static Cronometro empezar()
+{
+    return {chrono::steady_clock::now(), leer_contadores()};
+}
+
+/**
+ * @brief Cierra la medida de una etapa y la suma también al total del mensaje
+ *
+ * Los contadores se leen antes de guardar la latencia para no contar las
+ * reservas del propio benchmark.
+ */
+static void terminar(Cronometro const &cronometro, MedidaEtapa &medida, int64_t &total_ns, Contadores &total)
+{
+    Contadores ahora = leer_contadores();
+    Contadores nuevos{ahora.reservas - cronometro.contadores_inicio.reservas,
+                      ahora.bytes - cronometro.contadores_inicio.bytes,
+                      ahora.copiados - cronometro.contadores_inicio.copiados};
+    int64_t ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - cronometro.inicio).count();
+    medida.latencias.push_back(ns);
+    medida.contadores += nuevos;
+    total_ns += ns;
+    total += nuevos;
+}
+
+/**
+ * @brief Percentil (0..1) de un vector ya ordenado, en microsegundos
+ */
+static double percentil_us(vector<int64_t> const &ordenado, double p)
+{
+    if (ordenado.empty())
+        return 0.0;
+    size_t i = static_cast<size_t>(p * static_cast<double>(ordenado.size() - 1) + 0.5);
+    return static_cast<double>(ordenado[i]) / 1e3;
+}
+
+/**
+ * @brief Reproduce un registro completo midiendo cada etapa
+ *
+ * @param lector Registro abierto (se rebobina al principio)
+ * @param medidas Medidas acumuladas por etapa
+ * @param ciclos Contador de ciclos de decisión (mensajes see)
+ * @return Número de mensajes recibidos procesados
+ */
+static uint64_t reproducir(LectorRegistro &lector, vector<MedidaEtapa> &medidas, uint64_t &ciclos)
+{
+    rebobinar_lector(lector);
+    Registro registro;
+
+    Agente agente;
+    inicializacion_flags(agente.flags);
+    srand(0);
+
+    uint64_t mensajes = 0;
+    while (siguiente_registro(lector, registro))
+    {
+        string_view mensaje = registro.contenido;
+        if (registro.sentido == Sentido::Enviado)
+        {
+            if (mensaje.starts_with("(init "))
+            {
+                size_t fin = mensaje.find_first_of(" )", 6);
+                agente.datos.nombre_equipo = string(mensaje.substr(6, fin - 6));
+            }
+            continue;
+        }
+
+        if (!agente.inicializado)
+        {
+            try
+            {
+                procesar_init(mensaje, agente.datos, agente.comando_pendiente);
+            }
+            catch (const std::exception &)
+            {
+            }
+            agente.inicializado = true;
+            continue;
+        }
+        mensajes++;
+
+        // Mismas etapas que percibir() y actuar()
+        int64_t total_ns = 0;
+        Contadores total;
+        try
+        {
+            Cronometro c = empezar();
+            if (!tokenizar(mensaje, agente.arbol))
+                throw runtime_error("mensaje mal formado");
+            decodificar_see(agente.arbol, agente.datos.nombre_equipo, agente.observacion);
+            send_message_funtion(agente.arbol, agente.observacion, agente.datos);
+            terminar(c, medidas[PARSEO], total_ns, total);
+
+            if (texto_hijo(agente.arbol, 0, 0) == "sense_body")
+            {
+                c = empezar();
+                SenseBody sense;
+                if (decodificar_sense_body(agente.arbol, sense))
+                    actualizar_odometria(sense, agente.datos);
+                terminar(c, medidas[ODOMETRIA], total_ns, total);
+            }
+
+            if (agente.observacion.valida &&
+                (agente.datos.jugador.jugador_numero != 1 || agente.datos.ball.balon_distancia < 5))
+            {
+                c = empezar();
+                crear_matriz_valores_absolutos(agente.observacion, agente.flags);
+                relative2Abssolute(agente.flags, agente.datos);
+                terminar(c, medidas[LOCALIZACION], total_ns, total);
+            }
+
+            if (agente.observacion.valida)
+            {
+                c = empezar();
+                actualizar_balon(agente.observacion, agente.datos);
+                terminar(c, medidas[BALON], total_ns, total);
+
+                c = empezar();
+                proyectar_observaciones(agente.datos);
+                terminar(c, medidas[PROYECCION], total_ns, total);
+
+                c = empezar();
+                actualizar_mundo(agente.observacion.tiempo, agente.datos);
+                terminar(c, medidas[MUNDO], total_ns, total);
+            }
+
+            if (mensaje.starts_with("(see "))
+            {
+                c = empezar();
+                sendMessage(agente.datos, agente.comando_pendiente);
+                aplicar_comando_enviado(agente.comando_pendiente, agente.datos);
+                terminar(c, medidas[DECISION], total_ns, total);
+                ciclos++;
+            }
+        }
+        catch (const std::exception &)
+        {
+        }
+        medidas[TOTAL].latencias.push_back(total_ns);
+        medidas[TOTAL].contadores += total;
+    }
+    return mensajes;
+}
+
+int main(int argc, char *argv[])
+{
+    vector<string> ficheros;
+    int repeticiones = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--repeticiones" && i + 1 < argc)
+        {
+            if (leer_entero(argv[++i], repeticiones) != ErrorNumero::Ninguno || repeticiones < 1)
+                repeticiones = 1;
+        }
+        else
+            ficheros.push_back(arg);
+    }
+    if (ficheros.empty())
+    {
+        cout << "Uso: " << argv[0] << " <fichero.rlog>... [--repeticiones N]" << endl;
+        return 1;
+    }
+
+    vector<LectorRegistro> lectores(ficheros.size());
+    for (size_t i = 0; i < ficheros.size(); i++)
+    {
+        if (!abrir_lector(lectores[i], ficheros[i]))
+        {
+            cout << "No se puede abrir el registro " << ficheros[i] << endl;
+            return 1;
+        }
+    }
+
+    vector<MedidaEtapa> medidas(NUM_ETAPAS);
+    uint64_t mensajes = 0, ciclos = 0;
+    auto inicio = chrono::steady_clock::now();
+    for (int r = 0; r < repeticiones; r++)
+        for (auto &lector : lectores)
+            mensajes += reproducir(lector, medidas, ciclos);
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    for (auto &lector : lectores)
+        cerrar_lector(lector);
+
+    // ======================================================
+    // INFORME
+    // ======================================================
+    printf("Registros: %zu, repeticiones: %d, mensajes: %llu, ciclos (see): %llu\n",
+           ficheros.size(), repeticiones, static_cast<unsigned long long>(mensajes),
+           static_cast<unsigned long long>(ciclos));
+    printf("Rendimiento: %.0f mensajes/s (%.3f s)\n", segundos > 0 ? mensajes / segundos : 0.0, segundos);
+    printf("Escaner estructural: %s\n", nombre_nivel_simd(nivel_escaner()));
+    printf("Game_data: %zu bytes\n", sizeof(Game_data));
+    printf("%-13s %10s %10s %10s %16s %14s %16s\n", "etapa", "p50 us", "p99 us", "p999 us", "reservas/ciclo",
+           "bytes/ciclo", "copiados/ciclo");
+    for (int e = 0; e < NUM_ETAPAS; e++)
+    {
+        auto &latencias = medidas[e].latencias;
+        sort(latencias.begin(), latencias.end());
+        Contadores const &contadores = medidas[e].contadores;
+        double por_ciclo = ciclos > 0 ? 1.0 / static_cast<double>(ciclos) : 0.0;
+        printf("%-13s %10.2f %10.2f %10.2f %16.1f %14.1f %16.1f\n", NOMBRE_ETAPA[e],
+               percentil_us(latencias, 0.50), percentil_us(latencias, 0.99), percentil_us(latencias, 0.999),
+               contadores.reservas * por_ciclo, contadores.bytes * por_ciclo, contadores.copiados * por_ciclo);
+    }
+
+    // Presupuesto de la localización (AbsPos.h)
+    auto const &localizacion = medidas[LOCALIZACION].latencias;
+    size_t fuera = static_cast<size_t>(
+        localizacion.end() - upper_bound(localizacion.begin(), localizacion.end(),
+                                         static_cast<int64_t>(PRESUPUESTO_LOCALIZACION_US * 1e3)));
+    printf("Localizacion por encima de %.1f us: %zu de %zu (%.2f%%)\n", PRESUPUESTO_LOCALIZACION_US, fuera,
+           localizacion.size(), localizacion.empty() ? 0.0 : 100.0 * fuera / localizacion.size());
+    return 0;
+}
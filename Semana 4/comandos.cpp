@@ -0,0 +1,141 @@
+/**
+ * @file comandos.cpp
+ * @brief Implementación del codificador de comandos al servidor
+ */
+
+#include "comandos.h"
+
+#include <charconv>
+#include <cstring>
+
+/// Espacio reservado para "(change_view " o "(say " y el ")" final
+constexpr size_t TAM_CABECERA_COMANDO = 16;
+
+/**
+ * @brief Añade texto al comando
+ *
+ * Los comandos numéricos miden como mucho unos 70 bytes y los de texto se
+ * acotan antes de escribir, así que siempre cabe.
+ */
+static void anadir(Comando &comando, string_view texto)
+{
+    memcpy(comando.bytes.data() + comando.longitud, texto.data(), texto.size());
+    comando.longitud += texto.size();
+}
+
+/**
+ * @brief Añade " valor" al comando
+ *
+ * @param decimales DECIMALES_CORTO para la forma más corta, o decimales fijos
+ */
+static void anadir_numero(Comando &comando, float valor, int decimales)
+{
+    // Cabe cualquier float en notación fija con 6 decimales
+    char texto[64];
+    texto[0] = ' ';
+    to_chars_result resultado = (decimales == DECIMALES_CORTO)
+                                    ? to_chars(texto + 1, texto + sizeof(texto), valor)
+                                    : to_chars(texto + 1, texto + sizeof(texto), static_cast<double>(valor),
+                                               chars_format::fixed, decimales);
+    anadir(comando, string_view(texto, static_cast<size_t>(resultado.ptr - texto)));
+}
+
+/**
+ * @brief Añade " valor" entero al comando
+ */
+static void anadir_entero(Comando &comando, int valor)
+{
+    char texto[16];
+    texto[0] = ' ';
+    to_chars_result resultado = to_chars(texto + 1, texto + sizeof(texto), valor);
+    anadir(comando, string_view(texto, static_cast<size_t>(resultado.ptr - texto)));
+}
+
+/**
+ * @brief Empieza un comando "(nombre" y anota su tipo y parámetros
+ */
+static void empezar(Comando &comando, string_view nombre, TipoComando tipo, float p0 = 0, float p1 = 0)
+{
+    comando.longitud = 0;
+    comando.tipo = tipo;
+    comando.parametros = {p0, p1};
+    anadir(comando, "(");
+    anadir(comando, nombre);
+}
+
+/**
+ * @brief Cierra el comando con ")"
+ */
+static void terminar(Comando &comando)
+{
+    anadir(comando, ")");
+}
+
+void dash(Comando &comando, float potencia, float direccion)
+{
+    empezar(comando, "dash", TipoComando::Dash, potencia, direccion);
+    anadir_numero(comando, potencia, DECIMALES_CORTO);
+    anadir_numero(comando, direccion, DECIMALES_CORTO);
+    terminar(comando);
+}
+
+void kick(Comando &comando, float potencia, float direccion, int decimales_direccion)
+{
+    empezar(comando, "kick", TipoComando::Kick, potencia, direccion);
+    anadir_numero(comando, potencia, DECIMALES_CORTO);
+    anadir_numero(comando, direccion, decimales_direccion);
+    terminar(comando);
+}
+
+void turn(Comando &comando, float momento)
+{
+    empezar(comando, "turn", TipoComando::Turn, momento);
+    anadir_numero(comando, momento, DECIMALES_CORTO);
+    terminar(comando);
+}
+
+void turn_neck(Comando &comando, float angulo)
+{
+    empezar(comando, "turn_neck", TipoComando::TurnNeck, angulo);
+    anadir_numero(comando, angulo, DECIMALES_CORTO);
+    terminar(comando);
+}
+
+void catch_(Comando &comando, float direccion)
+{
+    empezar(comando, "catch", TipoComando::Catch, direccion);
+    anadir_numero(comando, direccion, DECIMALES_CORTO);
+    terminar(comando);
+}
+
+void move_(Comando &comando, int x, int y)
+{
+    empezar(comando, "move", TipoComando::Move, static_cast<float>(x), static_cast<float>(y));
+    anadir_entero(comando, x);
+    anadir_entero(comando, y);
+    terminar(comando);
+}
+
+void say(Comando &comando, string_view mensaje)
+{
+    if (mensaje.size() > TAM_MAX_COMANDO - TAM_CABECERA_COMANDO)
+    {
+        comando.limpiar();
+        return;
+    }
+    empezar(comando, "say ", TipoComando::Say);
+    anadir(comando, mensaje);
+    terminar(comando);
+}
+
+void change_view(Comando &comando, string_view ancho)
+{
+    if (ancho.size() > TAM_MAX_COMANDO - TAM_CABECERA_COMANDO)
+    {
+        comando.limpiar();
+        return;
+    }
+    empezar(comando, "change_view ", TipoComando::ChangeView);
+    anadir(comando, ancho);
+    terminar(comando);
+}
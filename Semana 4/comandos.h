@@ -0,0 +1,117 @@
+/**
+ * @file comandos.h
+ * @brief Archivo de cabecera del codificador de comandos al servidor
+ *
+ * Cada comando ((dash 100 -3), (kick 45 12.5), (turn 70)...) se escribe con
+ * std::to_chars en un buffer fijo que pertenece al agente, sin crear cadenas
+ * temporales. El socket recibe directamente una vista (span) de ese buffer,
+ * así que generar y enviar un comando no reserva memoria.
+ */
+
+#ifndef COMANDOS_H
+#define COMANDOS_H
+
+// Inclusión de dependencias
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+using namespace std;
+
+/// Capacidad del buffer de un comando (el más largo, un say, cabe de sobra)
+constexpr size_t TAM_MAX_COMANDO = 128;
+
+/// Tipo de comando codificado
+enum class TipoComando : uint8_t
+{
+    Ninguno,
+    Dash,
+    Kick,
+    Turn,
+    TurnNeck,
+    Catch,
+    Move,
+    Say,
+    ChangeView
+};
+
+/**
+ * @brief Comando ya codificado, listo para enviar
+ *
+ * Un comando vacío significa que no hay nada que enviar en el ciclo. Además
+ * del texto guarda su tipo y sus parámetros numéricos, para que el modelo del
+ * mundo pueda aplicar el efecto de lo enviado (giro del cuello, etc.) sin
+ * volver a leer el texto.
+ */
+struct Comando
+{
+    array<char, TAM_MAX_COMANDO> bytes;   ///< Texto del comando (sin '\0' final)
+    size_t longitud;                      ///< Bytes válidos en bytes
+    TipoComando tipo;                     ///< Tipo del comando codificado
+    array<float, 2> parametros;           ///< Parámetros numéricos en orden (potencia, dirección...)
+
+    /**
+     * @brief Constructor por defecto (comando vacío)
+     */
+    Comando()
+        : bytes(), longitud(0), tipo(TipoComando::Ninguno), parametros() {}
+
+    string_view texto() const { return string_view(bytes.data(), longitud); }
+    span<const char> datos() const { return span<const char>(bytes.data(), longitud); }
+    bool vacio() const { return longitud == 0; }
+    void limpiar()
+    {
+        longitud = 0;
+        tipo = TipoComando::Ninguno;
+    }
+};
+
+/// Decimales de un número en un comando: -1 es la forma más corta ("12.5", "-3")
+constexpr int DECIMALES_CORTO = -1;
+
+/**
+ * @brief (dash potencia direccion)
+ */
+void dash(Comando &comando, float potencia, float direccion);
+
+/**
+ * @brief (kick potencia direccion)
+ *
+ * @param decimales_direccion DECIMALES_CORTO, o un número fijo de decimales
+ *        (6 equivale a std::to_string)
+ */
+void kick(Comando &comando, float potencia, float direccion, int decimales_direccion = DECIMALES_CORTO);
+
+/**
+ * @brief (turn momento)
+ */
+void turn(Comando &comando, float momento);
+
+/**
+ * @brief (turn_neck angulo)
+ */
+void turn_neck(Comando &comando, float angulo);
+
+/**
+ * @brief (catch direccion); con guion bajo porque catch es palabra reservada
+ */
+void catch_(Comando &comando, float direccion);
+
+/**
+ * @brief (move x y) con coordenadas enteras del servidor; con guion bajo para no chocar con std::move
+ */
+void move_(Comando &comando, int x, int y);
+
+/**
+ * @brief (say mensaje); el comando queda vacío si el mensaje no cabe
+ */
+void say(Comando &comando, string_view mensaje);
+
+/**
+ * @brief (change_view ancho) con ancho "narrow", "normal" o "wide"
+ */
+void change_view(Comando &comando, string_view ancho);
+
+#endif // COMANDOS_H
@@ -6,18 +6,24 @@
  * inicialización del jugador y bucle principal de percepción-decisión-acción.
  */
 
+#include <csignal>
 #include <iostream>
-#include "Funciones.h"
-#include "AbsPos.h"
+#include <poll.h>
+#include "agente.h"
+#include "numeros.h"
 #include "structs.h"
 
+/// Se activa con SIGINT/SIGTERM para cerrar el agente (y volcar su registro)
+static volatile sig_atomic_t fin_solicitado = 0;
 
-int main(int argc, char *argv[])
+static void terminar(int)
 {
-    Game_data datos;
+    fin_solicitado = 1;
+}
 
-    vector<shared_ptr<knownFlags>> flags;
-    inicializacion_flags(flags);
+int main(int argc, char *argv[])
+{
+    Agente agente;
 
     // Verificación de argumentos de línea de comandos
     if (argc != 3 && argc != 4)
@@ -26,80 +32,56 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    bool soy_portero = (argc == 4 && string(argv[3]) == "goalie");
-    datos.nombre_equipo = argv[1];
+    agente.soy_portero = (argc == 4 && string(argv[3]) == "goalie");
 
-    //numero del puerto stoi pasa de letra a numero
-    MinimalSocket::Port this_socket_port = stoi(argv[2]);
+    //numero del puerto
+    int puerto{0};
+    if (leer_entero(argv[2], puerto) != ErrorNumero::Ninguno || puerto <= 0 || puerto > 65535)
+    {
+        cout << "Puerto no válido: " << argv[2] << endl;
+        return 1;
+    }
+    uint16_t this_socket_port = static_cast<uint16_t>(puerto);
 
     cout << "Creando socket UDP..." << endl;
 
-    // Creación del socket UDP IPv6 para comunicación con el servidor
-    MinimalSocket::udp::Udp<true> udp_socket(this_socket_port, MinimalSocket::AddressFamily::IP_V6);
-    cout << "Socket creado correctamente" << endl;
-
-    // Apertura del socket
-    bool success = udp_socket.open();
+    // Creación y apertura del socket UDP; servidor en localhost puerto 6000
+    bool success = abrir_agente(agente, argv[1], this_socket_port, "127.0.0.1", 6000);
     if (!success)
     {
         cout << "Error al abrir el socket" << endl;
         return 1;
     }
+    cout << "Socket creado correctamente" << endl;
+    activar_grabacion(agente, this_socket_port);
 
-    // Configuración de dirección del servidor (localhost puerto 6000)
-    MinimalSocket::Address other_recipient_udp = MinimalSocket::Address{"127.0.0.1", 6000};
-
-    string init_msg;
-    if (soy_portero)
-        init_msg = "(init " + datos.nombre_equipo + " (version 19) (goalie))";
-    else
-        init_msg = "(init " + datos.nombre_equipo + " (version 19))";
-
-    udp_socket.sendTo(init_msg, other_recipient_udp);
-    cout << "Mensaje de inicialización enviado: " << init_msg << endl;
-
-    // Espera y recepción de la respuesta del servidor
-    std::size_t message_max_size = 1000000;
+    enviar_init(agente);
+    cout << "Mensaje de inicialización enviado" << endl;
     cout << "Esperando mensaje del servidor..." << endl;
-    auto received_message = udp_socket.receive(message_max_size);
-    std::string received_message_content = received_message->received_message;
-
-    // Actualización de la dirección del servidor con el puerto que respondió
-    MinimalSocket::Address other_sender_udp = received_message->sender;
-    MinimalSocket::Address server_udp = MinimalSocket::Address{"127.0.0.1", other_sender_udp.getPort()};
-    sendInitialMoveMessage(received_message_content, udp_socket, server_udp, datos);
 
-    while(true){
-        string received_message_content = received_message-> received_message;
-        do{
-            received_message = udp_socket.receive(message_max_size);
-            received_message_content = received_message->received_message;
-            try
-            {
-                send_message_funtion(received_message_content, datos);
-                if (datos.jugador.jugador_numero != "1" || stof(datos.ball.balon_distancia) < 5)
-                {
-                    crear_matriz_valores_absolutos(received_message_content, flags); // ABSOLUTOS
-                    relative2Abssolute(flags, datos);                                // ABSOLUTOS
-                }
-            }
-            catch (const std::exception &e)
-            {
-                cout << e.what() << endl;
-            }
-        } while (received_message_content.find("(see") == -1);
-        string envio = sendMessage(datos);
-        //cout << envio << endl;
-        if (envio != ""){
-            udp_socket.sendTo(envio,server_udp);
-        }
+    // El socket es no bloqueante: esperamos con poll y drenamos todo lo pendiente.
+    // Los mensajes se leen en los buffers fijos del agente (sin reservas de memoria)
+    // y solo se analiza el "see" más reciente de cada drenaje
+    // El comando decidido sale cuando vence el temporizador (último instante seguro del ciclo)
+    signal(SIGINT, terminar);
+    signal(SIGTERM, terminar);
+    pollfd espera[2] = {{agente.socket_fd, POLLIN, 0}, {agente.temporizador_fd, POLLIN, 0}};
+    while(!fin_solicitado){
+        if (poll(espera, 2, -1) <= 0)
+            continue;
+        if ((espera[0].revents & POLLIN) && ingerir_pendientes(agente))
+            actuar(agente);
+        if (espera[1].revents & POLLIN)
+            despachar_pendiente(agente);
     }
+    cerrar_agente(agente);
+    return 0;
 }
 
 /**
  * @brief Ciclo de percepción-decisión-acción del agente:
  *
- * 1. PERCEPCIÓN: Recibe y procesa mensajes del servidor
+ * 1. PERCEPCIÓN: Recibe y procesa mensajes del servidor (percibir() en agente.cpp)
  *    - Mensajes "hear": eventos del juego
  *    - Mensajes "see": percepción visual
  *    - Calcula posición absoluta con flags
@@ -109,7 +91,7 @@ int main(int argc, char *argv[])
  *    - Considera posición, balón, compañeros, rivales
  *    - Implementa estrategias tácticas por posición
  *
- * 3. ACCIÓN: Envía comando al servidor
+ * 3. ACCIÓN: Envía comando al servidor (actuar() en agente.cpp)
  *    - Comandos: move, turn, dash, kick, catch
  *    - Se ejecutan en el siguiente ciclo del simulador
  *
@@ -119,8 +101,8 @@ int main(int argc, char *argv[])
  */
 
 /**
- * @param argc Número de argumentos (debe ser 3)
- * @param argv Argumentos: [0]nombre_programa [1]nombre_equipo [2]puerto
+ * @param argc Número de argumentos (3, o 4 para el portero)
+ * @param argv Argumentos: [0]nombre_programa [1]nombre_equipo [2]puerto [3]goalie
  * @return 0 si éxito, 1 si error de configuración
  *
  * @example Ejecución: ./player MiEquipo 5000
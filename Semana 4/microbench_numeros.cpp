@@ -0,0 +1,138 @@
+/**
+ * @file microbench_numeros.cpp
+ * @brief Microbenchmark de la lectura de campos numéricos del protocolo
+ *
+ * Extrae de los "see" de uno o varios registros binarios todos los campos
+ * numéricos (distancias, ángulos, cambios, dorsales y tiempos) y mide el
+ * coste por campo de la conversión anterior (copia a std::string + stod /
+ * stof / stoi) frente a leer_float / leer_entero sobre el propio buffer.
+ *
+ * Uso: ./bench_numeros <fichero.rlog>... [--repeticiones N]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "numeros.h"
+#include "registro.h"
+#include "utilities.h"
+
+/**
+ * @brief Recorre una lista de campos aplicando una conversión y mide ns por campo
+ *
+ * @param campos Campos a convertir
+ * @param repeticiones Veces que se recorre la lista
+ * @param convertir Conversión a medir; devuelve el valor leído
+ * @param suma Acumulador para que el compilador no descarte el trabajo
+ * @return Nanosegundos medios por campo
+ */
+template <typename Conversion>
+static double medir(vector<string_view> const &campos, int repeticiones, Conversion convertir, double &suma)
+{
+    auto inicio = chrono::steady_clock::now();
+    for (int r = 0; r < repeticiones; r++)
+        for (auto campo : campos)
+            suma += convertir(campo);
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - inicio).count();
+    return ns / (static_cast<double>(campos.size()) * repeticiones);
+}
+
+int main(int argc, char *argv[])
+{
+    vector<string> ficheros;
+    int repeticiones = 20;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--repeticiones" && i + 1 < argc)
+        {
+            if (leer_entero(argv[++i], repeticiones) != ErrorNumero::Ninguno || repeticiones < 1)
+                repeticiones = 1;
+        }
+        else
+            ficheros.push_back(arg);
+    }
+    if (ficheros.empty())
+    {
+        printf("Uso: %s <fichero.rlog>... [--repeticiones N]\n", argv[0]);
+        return 1;
+    }
+
+    // ======================================================
+    // EXTRACCIÓN DE CAMPOS DE LOS "see"
+    // ======================================================
+    vector<LectorRegistro> lectores(ficheros.size());
+    vector<string_view> reales, enteros;
+    ArbolSexp arbol;
+    for (size_t f = 0; f < ficheros.size(); f++)
+    {
+        if (!abrir_lector(lectores[f], ficheros[f]))
+        {
+            printf("No se puede abrir el registro %s\n", ficheros[f].c_str());
+            return 1;
+        }
+
+        Registro registro;
+        while (siguiente_registro(lectores[f], registro))
+        {
+            if (registro.sentido != Sentido::Recibido || !registro.contenido.starts_with("(see ") ||
+                !tokenizar(registro.contenido, arbol))
+                continue;
+
+            enteros.push_back(texto_hijo(arbol, 0, 1)); // tiempo
+            for (int o = hijo(arbol, 0, 2); o != -1; o = arbol.nodos[o].siguiente)
+            {
+                int nombre = arbol.nodos[o].primer_hijo;
+                if (nombre == -1)
+                    continue;
+                if (texto_hijo(arbol, nombre, 0) == "p" && hijo(arbol, nombre, 2) != -1)
+                    enteros.push_back(texto_hijo(arbol, nombre, 2)); // dorsal
+                for (int h = arbol.nodos[nombre].siguiente; h != -1; h = arbol.nodos[h].siguiente)
+                {
+                    string_view valor = arbol.nodos[h].texto;
+                    if (!valor.empty() && (valor[0] == '-' || (valor[0] >= '0' && valor[0] <= '9')))
+                        reales.push_back(valor);
+                }
+            }
+        }
+    }
+    if (reales.empty())
+    {
+        printf("No hay mensajes see en los registros\n");
+        return 1;
+    }
+
+    // ======================================================
+    // MEDIDAS
+    // ======================================================
+    double suma = 0.0;
+    double ns_stod = medir(reales, repeticiones, [](string_view c) { return stod(string(c)); }, suma);
+    double ns_stof = medir(reales, repeticiones, [](string_view c) { return static_cast<double>(stof(string(c))); }, suma);
+    double ns_float = medir(reales, repeticiones, [](string_view c) {
+        float v = 0.0f;
+        leer_float(c, v);
+        return static_cast<double>(v);
+    }, suma);
+    double ns_stoi = medir(enteros, repeticiones, [](string_view c) { return static_cast<double>(stoi(string(c))); }, suma);
+    double ns_entero = medir(enteros, repeticiones, [](string_view c) {
+        int v = 0;
+        leer_entero(c, v);
+        return static_cast<double>(v);
+    }, suma);
+
+    for (auto &lector : lectores)
+        cerrar_lector(lector);
+
+    printf("Campos reales: %zu, enteros: %zu, repeticiones: %d\n", reales.size(), enteros.size(), repeticiones);
+    printf("%-28s %10s\n", "conversion", "ns/campo");
+    printf("%-28s %10.2f\n", "string + stod", ns_stod);
+    printf("%-28s %10.2f\n", "string + stof", ns_stof);
+    printf("%-28s %10.2f\n", "leer_float (from_chars)", ns_float);
+    printf("%-28s %10.2f\n", "string + stoi", ns_stoi);
+    printf("%-28s %10.2f\n", "leer_entero (from_chars)", ns_entero);
+    printf("(suma de control: %.1f)\n", suma);
+    return 0;
+}
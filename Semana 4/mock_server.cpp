@@ -0,0 +1,701 @@
+/**
+ * @file mock_server.cpp
+ * @brief Servidor RCSS simulado para pruebas de carga y latencia en local
+ *
+ * Sustituto mínimo de rcssserver que habla lo suficiente del protocolo v19
+ * para que los agentes de este proyecto jueguen sin dependencias externas:
+ *
+ * - Handshake (init EQUIPO (version 19) [(goalie)]) respondido desde un
+ *   puerto propio por jugador, como el servidor real.
+ * - Comandos move, dash, turn, kick y catch con una física simplificada
+ *   (aceleración, decaimiento y límites de velocidad del servidor).
+ * - Envío de sense_body, see y hear en cada ciclo, generados a partir del
+ *   mundo simulado o reproducidos desde un fichero de texto (--replay).
+ * - Medida de la latencia de respuesta de cada agente por ciclo (desde el
+ *   sense_body hasta el primer comando recibido) y de los ciclos perdidos.
+ *
+ * Uso: ./mock_rcssserver [--puerto 6000] [--ciclo-ms 100] [--see-cada 1]
+ *                        [--ciclos 0] [--inicio 20] [--replay fichero]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+using namespace std;
+
+// ======================================================
+// PARÁMETROS DEL SERVIDOR (valores por defecto de rcssserver)
+// ======================================================
+constexpr double LARGO_CAMPO = 105.0;
+constexpr double ANCHO_CAMPO = 68.0;
+constexpr double ANCHO_PORTERIA = 14.02;
+constexpr double ANGULO_VISION = 120.0;      ///< view_width normal
+constexpr double DECAY_JUGADOR = 0.4;
+constexpr double DECAY_BALON = 0.94;
+constexpr double VELOCIDAD_MAX_JUGADOR = 1.05;
+constexpr double VELOCIDAD_MAX_BALON = 3.0;
+constexpr double DASH_POWER_RATE = 0.006;
+constexpr double KICK_POWER_RATE = 0.027;
+constexpr double INERCIA_GIRO = 5.0;
+constexpr double DISTANCIA_CHUTABLE = 0.7 + 0.3 + 0.085;  ///< kickable_margin + player_size + ball_size
+constexpr double DISTANCIA_ATRAPE = 2.0;
+constexpr double STAMINA_MAX = 8000.0;
+constexpr double RECUPERACION_STAMINA = 45.0;
+constexpr double DISTANCIA_NUMERO = 20.0;   ///< unum_far_length
+constexpr double DISTANCIA_EQUIPO = 40.0;   ///< team_far_length
+
+/**
+ * @brief Punto de referencia fijo del campo (coordenadas del servidor, Y hacia abajo)
+ */
+struct Marca
+{
+    string nombre;  ///< Nombre en el protocolo (ej: "f p l t")
+    double x;
+    double y;
+};
+
+/**
+ * @brief Estado de un jugador conectado
+ */
+struct Cliente
+{
+    int fd;                       ///< Socket propio desde el que se le responde
+    sockaddr_in direccion;        ///< Dirección del agente
+    string equipo;
+    char lado;                    ///< 'l' o 'r'
+    int numero;
+    bool portero;
+
+    double x, y, vx, vy;          ///< Posición y velocidad en el campo
+    double cuerpo;                ///< Dirección del cuerpo (grados, sentido horario)
+    double stamina;
+
+    string comando_ciclo;         ///< Último comando de cuerpo recibido en el ciclo
+    bool comando_en_ciclo;
+    int contador_kick, contador_dash, contador_turn, contador_move, contador_catch;
+
+    vector<int64_t> latencias_ns; ///< Latencia del primer comando de cada ciclo
+    uint64_t ciclos;              ///< Ciclos transcurridos desde la conexión
+    uint64_t ciclos_perdidos;     ///< Ciclos sin ningún comando
+    uint64_t comandos;            ///< Comandos recibidos en total
+};
+
+/**
+ * @brief Configuración de la ejecución
+ */
+struct Config
+{
+    int puerto = 6000;
+    int ciclo_ms = 100;
+    int see_cada = 1;          ///< Ciclos entre mensajes see
+    uint64_t ciclos = 0;       ///< 0: sin límite (hasta SIGINT)
+    int inicio = 20;           ///< Ciclos de before_kick_off antes del saque
+    string replay;             ///< Fichero de mensajes a reproducir en lugar de generarlos
+};
+
+static volatile sig_atomic_t fin_solicitado = 0;
+
+static void terminar(int)
+{
+    fin_solicitado = 1;
+}
+
+static int64_t ahora_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Normaliza un ángulo en grados al intervalo [-180, 180)
+ */
+static double normalizar(double angulo)
+{
+    while (angulo >= 180.0)
+        angulo -= 360.0;
+    while (angulo < -180.0)
+        angulo += 360.0;
+    return angulo;
+}
+
+/**
+ * @brief Cuantiza una distancia como el servidor (paso logarítmico y décimas)
+ */
+static double cuantizar(double distancia, double paso)
+{
+    double d = exp(round(log(distancia + 1e-10) / paso) * paso);
+    return round(d * 10.0) / 10.0;
+}
+
+/**
+ * @brief Construye la lista de los 55 flags y 2 porterías del servidor
+ */
+static vector<Marca> crear_marcas()
+{
+    const double L = LARGO_CAMPO / 2, A = ANCHO_CAMPO / 2, P = ANCHO_PORTERIA / 2;
+    vector<Marca> m = {
+        {"f c", 0, 0}, {"f c t", 0, -A}, {"f c b", 0, A},
+        {"f l t", -L, -A}, {"f l b", -L, A}, {"f r t", L, -A}, {"f r b", L, A},
+        {"f p l t", -L + 16.5, -20.16}, {"f p l c", -L + 16.5, 0}, {"f p l b", -L + 16.5, 20.16},
+        {"f p r t", L - 16.5, -20.16}, {"f p r c", L - 16.5, 0}, {"f p r b", L - 16.5, 20.16},
+        {"f g l t", -L, -P}, {"f g l b", -L, P}, {"f g r t", L, -P}, {"f g r b", L, P},
+        {"g l", -L, 0}, {"g r", L, 0},
+        {"f t 0", 0, -A - 5}, {"f b 0", 0, A + 5}, {"f l 0", -L - 5, 0}, {"f r 0", L + 5, 0},
+    };
+    for (double d = 10; d <= 50; d += 10)
+    {
+        m.push_back({"f t l " + to_string(static_cast<int>(d)), -d, -A - 5});
+        m.push_back({"f t r " + to_string(static_cast<int>(d)), d, -A - 5});
+        m.push_back({"f b l " + to_string(static_cast<int>(d)), -d, A + 5});
+        m.push_back({"f b r " + to_string(static_cast<int>(d)), d, A + 5});
+    }
+    for (double d = 10; d <= 30; d += 10)
+    {
+        m.push_back({"f l t " + to_string(static_cast<int>(d)), -L - 5, -d});
+        m.push_back({"f l b " + to_string(static_cast<int>(d)), -L - 5, d});
+        m.push_back({"f r t " + to_string(static_cast<int>(d)), L + 5, -d});
+        m.push_back({"f r b " + to_string(static_cast<int>(d)), L + 5, d});
+    }
+    return m;
+}
+
+/**
+ * @brief Estado global de la simulación
+ */
+struct Servidor
+{
+    Config config;
+    int fd_principal = -1;
+    int epoll_fd = -1;
+    int temporizador_fd = -1;
+    vector<Cliente> clientes;
+    vector<Marca> marcas = crear_marcas();
+    vector<vector<string>> replay;   ///< Mensajes por ciclo en modo replay
+    double balon_x = 0, balon_y = 0, balon_vx = 0, balon_vy = 0;
+    int ciclo = 0;
+    string modo = "before_kick_off";
+    int goles_l = 0, goles_r = 0;
+    int64_t inicio_ciclo_ns = 0;
+};
+
+static void enviar(Cliente const &c, string const &mensaje)
+{
+    // El servidor real termina cada mensaje con '\0'
+    sendto(c.fd, mensaje.c_str(), mensaje.size() + 1, 0,
+           reinterpret_cast<sockaddr const *>(&c.direccion), sizeof(c.direccion));
+}
+
+static void difundir_modo(Servidor &s, string const &modo)
+{
+    s.modo = modo;
+    for (auto const &c : s.clientes)
+        enviar(c, "(hear " + to_string(s.ciclo) + " referee " + modo + ")");
+}
+
+// ======================================================
+// CONEXIÓN DE JUGADORES
+// ======================================================
+
+/**
+ * @brief Atiende un (init ...) recibido en el puerto principal
+ */
+static void atender_init(Servidor &s, string_view mensaje, sockaddr_in const &origen)
+{
+    if (!mensaje.starts_with("(init "))
+        return;
+    size_t fin_nombre = mensaje.find_first_of(" )", 6);
+    string equipo(mensaje.substr(6, fin_nombre - 6));
+    bool portero = mensaje.find("(goalie)") != string_view::npos;
+
+    // Los dos primeros equipos que se conectan juegan en 'l' y 'r'
+    char lado = 0;
+    int numero = 1;
+    string equipo_l;
+    for (auto const &c : s.clientes)
+    {
+        if (c.lado == 'l')
+            equipo_l = c.equipo;
+        if (c.equipo == equipo)
+        {
+            lado = c.lado;
+            numero++;
+        }
+    }
+    if (lado == 0)
+        lado = equipo_l.empty() ? 'l' : (equipo_l == equipo ? 'l' : 'r');
+    bool lado_ocupado = any_of(s.clientes.begin(), s.clientes.end(), [&](Cliente const &c)
+                               { return c.lado == lado && c.equipo != equipo; });
+
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr *>(&local), sizeof(local));
+
+    if (numero > 11 || lado_ocupado)
+    {
+        const char error[] = "(error no_more_team_or_player_or_goalie)";
+        sendto(fd, error, sizeof(error), 0, reinterpret_cast<sockaddr const *>(&origen), sizeof(origen));
+        close(fd);
+        return;
+    }
+
+    Cliente c{};
+    c.fd = fd;
+    c.direccion = origen;
+    c.equipo = equipo;
+    c.lado = lado;
+    c.numero = numero;
+    c.portero = portero;
+    c.x = (lado == 'l' ? -1 : 1) * (5.0 + 3.0 * numero);
+    c.y = (numero % 2 ? -1 : 1) * (ANCHO_CAMPO / 2 + 2);
+    c.cuerpo = (lado == 'l') ? 0 : 180;
+    c.stamina = STAMINA_MAX;
+    s.clientes.push_back(c);
+
+    epoll_event evento{};
+    evento.events = EPOLLIN;
+    evento.data.u32 = static_cast<uint32_t>(s.clientes.size());  // 0 reservado al puerto principal
+    epoll_ctl(s.epoll_fd, EPOLL_CTL_ADD, fd, &evento);
+
+    enviar(s.clientes.back(), string("(init ") + lado + " " + to_string(numero) + " " + s.modo + ")");
+    cout << "Conectado " << equipo << " " << numero << " (" << lado << ")" << (portero ? " portero" : "") << endl;
+}
+
+// ======================================================
+// COMANDOS DE LOS JUGADORES
+// ======================================================
+
+/**
+ * @brief Lee hasta dos argumentos numéricos de un comando "(nombre a b)"
+ */
+static int argumentos(string_view comando, double &a, double &b)
+{
+    string texto(comando);
+    size_t espacio = texto.find(' ');
+    if (espacio == string::npos)
+        return 0;
+    return sscanf(texto.c_str() + espacio, "%lf %lf", &a, &b);
+}
+
+/**
+ * @brief Registra un comando recibido de un jugador
+ *
+ * Los comandos de cuerpo (dash, turn, kick, catch, move) se ejecutan al final
+ * del ciclo; si llegan varios en el mismo ciclo vale el último.
+ */
+static void atender_comando(Servidor &s, Cliente &c, string_view mensaje)
+{
+    while (!mensaje.empty() && mensaje.back() == '\0')
+        mensaje.remove_suffix(1);
+
+    if (!c.comando_en_ciclo)
+    {
+        c.comando_en_ciclo = true;
+        c.latencias_ns.push_back(ahora_ns() - s.inicio_ciclo_ns);
+    }
+    c.comandos++;
+
+    if (mensaje.starts_with("(bye"))
+        return;
+    c.comando_ciclo.assign(mensaje);
+}
+
+/**
+ * @brief Ejecuta el comando de cuerpo pendiente de un jugador
+ */
+static void ejecutar_comando(Servidor &s, Cliente &c)
+{
+    string_view comando = c.comando_ciclo;
+    double a = 0, b = 0;
+    int n = argumentos(comando, a, b);
+
+    if (comando.starts_with("(dash") && n >= 1)
+    {
+        double potencia = clamp(a, -100.0, 100.0);
+        double direccion = (n >= 2) ? b : 0.0;
+        potencia = min(potencia, c.stamina);
+        c.stamina -= (potencia > 0) ? potencia : -2 * potencia;
+        double angulo = (c.cuerpo + direccion) * M_PI / 180;
+        c.vx += potencia * DASH_POWER_RATE * cos(angulo);
+        c.vy += potencia * DASH_POWER_RATE * sin(angulo);
+        c.contador_dash++;
+    }
+    else if (comando.starts_with("(turn") && n >= 1)
+    {
+        double velocidad = hypot(c.vx, c.vy);
+        c.cuerpo = normalizar(c.cuerpo + clamp(a, -180.0, 180.0) / (1 + INERCIA_GIRO * velocidad));
+        c.contador_turn++;
+    }
+    else if (comando.starts_with("(kick") && n >= 2)
+    {
+        double dx = s.balon_x - c.x, dy = s.balon_y - c.y;
+        double distancia = hypot(dx, dy);
+        if (distancia <= DISTANCIA_CHUTABLE)
+        {
+            double dir_balon = fabs(normalizar(atan2(dy, dx) * 180 / M_PI - c.cuerpo));
+            double efectividad = 1 - 0.25 * dir_balon / 180 - 0.25 * (distancia - 0.385) / 0.7;
+            double potencia = clamp(a, -100.0, 100.0) * KICK_POWER_RATE * efectividad;
+            double angulo = (c.cuerpo + b) * M_PI / 180;
+            s.balon_vx += potencia * cos(angulo);
+            s.balon_vy += potencia * sin(angulo);
+            if (s.modo != "play_on")
+                difundir_modo(s, "play_on");
+        }
+        c.contador_kick++;
+    }
+    else if (comando.starts_with("(catch"))
+    {
+        if (c.portero && hypot(s.balon_x - c.x, s.balon_y - c.y) <= DISTANCIA_ATRAPE)
+        {
+            s.balon_vx = s.balon_vy = 0;
+            s.balon_x = c.x;
+            s.balon_y = c.y;
+        }
+        c.contador_catch++;
+    }
+    else if (comando.starts_with("(move") && n >= 2)
+    {
+        // Coordenadas del propio campo: el equipo derecho se refleja
+        if (s.modo == "before_kick_off" || s.modo.starts_with("goal_"))
+        {
+            double signo = (c.lado == 'l') ? 1 : -1;
+            c.x = signo * clamp(a, -LARGO_CAMPO / 2, LARGO_CAMPO / 2);
+            c.y = signo * clamp(b, -ANCHO_CAMPO / 2, ANCHO_CAMPO / 2);
+            c.vx = c.vy = 0;
+        }
+        c.contador_move++;
+    }
+    c.comando_ciclo.clear();
+}
+
+// ======================================================
+// AVANCE DE LA SIMULACIÓN
+// ======================================================
+
+static void avanzar_mundo(Servidor &s)
+{
+    for (auto &c : s.clientes)
+    {
+        ejecutar_comando(s, c);
+
+        double velocidad = hypot(c.vx, c.vy);
+        if (velocidad > VELOCIDAD_MAX_JUGADOR)
+        {
+            c.vx *= VELOCIDAD_MAX_JUGADOR / velocidad;
+            c.vy *= VELOCIDAD_MAX_JUGADOR / velocidad;
+        }
+        c.x += c.vx;
+        c.y += c.vy;
+        c.vx *= DECAY_JUGADOR;
+        c.vy *= DECAY_JUGADOR;
+        c.stamina = min(STAMINA_MAX, c.stamina + RECUPERACION_STAMINA);
+    }
+
+    double velocidad = hypot(s.balon_vx, s.balon_vy);
+    if (velocidad > VELOCIDAD_MAX_BALON)
+    {
+        s.balon_vx *= VELOCIDAD_MAX_BALON / velocidad;
+        s.balon_vy *= VELOCIDAD_MAX_BALON / velocidad;
+    }
+    s.balon_x += s.balon_vx;
+    s.balon_y += s.balon_vy;
+    s.balon_vx *= DECAY_BALON;
+    s.balon_vy *= DECAY_BALON;
+
+    // Gol o balón fuera: se recoloca en el centro con saque del equipo contrario
+    if (fabs(s.balon_x) > LARGO_CAMPO / 2 || fabs(s.balon_y) > ANCHO_CAMPO / 2)
+    {
+        bool gol = fabs(s.balon_x) > LARGO_CAMPO / 2 && fabs(s.balon_y) < ANCHO_PORTERIA / 2;
+        bool derecha = s.balon_x > 0;
+        s.balon_x = s.balon_y = s.balon_vx = s.balon_vy = 0;
+        if (gol)
+            difundir_modo(s, derecha ? "goal_l_" + to_string(++s.goles_l) : "goal_r_" + to_string(++s.goles_r));
+        difundir_modo(s, derecha ? "kick_off_r" : "kick_off_l");
+    }
+}
+
+/**
+ * @brief Describe un objeto visto: distancia y dirección relativas a la cabeza
+ *
+ * @return false si el objeto queda fuera del cono de visión
+ */
+static bool relativo(Cliente const &c, double x, double y, double &distancia, double &direccion)
+{
+    distancia = hypot(x - c.x, y - c.y);
+    direccion = normalizar(atan2(y - c.y, x - c.x) * 180 / M_PI - c.cuerpo);
+    return fabs(direccion) <= ANGULO_VISION / 2;
+}
+
+static string formatear(double valor)
+{
+    char texto[32];
+    snprintf(texto, sizeof(texto), "%.4g", valor);
+    return texto;
+}
+
+/**
+ * @brief Genera el see de un jugador a partir del mundo simulado
+ */
+static string generar_see(Servidor const &s, Cliente const &c)
+{
+    string see = "(see " + to_string(s.ciclo);
+    double d, dir;
+
+    for (auto const &m : s.marcas)
+    {
+        if (!relativo(c, m.x, m.y, d, dir))
+            continue;
+        see += " ((" + m.nombre + ") " + formatear(cuantizar(d, 0.01)) + " " + to_string(lround(dir)) + ")";
+    }
+
+    if (relativo(c, s.balon_x, s.balon_y, d, dir))
+    {
+        // Cambio de distancia y dirección según la velocidad relativa del balón
+        double rx = s.balon_x - c.x, ry = s.balon_y - c.y;
+        double rvx = s.balon_vx - c.vx, rvy = s.balon_vy - c.vy;
+        double cambio_dist = (d > 0) ? (rx * rvx + ry * rvy) / d : 0;
+        double cambio_dir = (d > 0) ? (rx * rvy - ry * rvx) / (d * d) * 180 / M_PI : 0;
+        see += " ((b) " + formatear(cuantizar(d, 0.1)) + " " + to_string(lround(dir)) + " " +
+               formatear(cambio_dist) + " " + formatear(cambio_dir) + ")";
+    }
+
+    for (auto const &otro : s.clientes)
+    {
+        if (&otro == &c || !relativo(c, otro.x, otro.y, d, dir))
+            continue;
+        string nombre = "(p";
+        if (d <= DISTANCIA_EQUIPO)
+            nombre += " \"" + otro.equipo + "\"";
+        if (d <= DISTANCIA_NUMERO)
+            nombre += " " + to_string(otro.numero) + (otro.portero ? " goalie" : "");
+        see += " (" + nombre + ") " + formatear(cuantizar(d, 0.1)) + " " + to_string(lround(dir)) + ")";
+    }
+    return see + ")";
+}
+
+static string generar_sense_body(Servidor const &s, Cliente const &c)
+{
+    double velocidad = hypot(c.vx, c.vy);
+    double direccion = (velocidad > 0) ? normalizar(atan2(c.vy, c.vx) * 180 / M_PI - c.cuerpo) : 0;
+    return "(sense_body " + to_string(s.ciclo) + " (view_mode high normal) (stamina " +
+           formatear(c.stamina) + " 1 130600) (speed " + formatear(velocidad) + " " +
+           to_string(lround(direccion)) + ") (head_angle 0) (kick " + to_string(c.contador_kick) +
+           ") (dash " + to_string(c.contador_dash) + ") (turn " + to_string(c.contador_turn) +
+           ") (say 0) (turn_neck 0) (catch " + to_string(c.contador_catch) + ") (move " +
+           to_string(c.contador_move) + ") (change_view 0))";
+}
+
+/**
+ * @brief Cierra el ciclo actual y envía las percepciones del siguiente
+ */
+static void nuevo_ciclo(Servidor &s)
+{
+    // Contabilidad del ciclo que termina
+    for (auto &c : s.clientes)
+    {
+        c.ciclos++;
+        if (!c.comando_en_ciclo)
+            c.ciclos_perdidos++;
+        c.comando_en_ciclo = false;
+    }
+
+    avanzar_mundo(s);
+    s.ciclo++;
+    if (s.modo == "before_kick_off" && s.ciclo >= s.config.inicio && !s.clientes.empty())
+        difundir_modo(s, "kick_off_l");
+    else if (s.modo.starts_with("kick_off") && s.ciclo % 10 == 0)
+        difundir_modo(s, "play_on");
+
+    s.inicio_ciclo_ns = ahora_ns();
+    bool toca_see = (s.ciclo % s.config.see_cada) == 0;
+
+    if (!s.replay.empty())
+    {
+        for (auto const &mensaje : s.replay[s.ciclo % s.replay.size()])
+            for (auto const &c : s.clientes)
+                enviar(c, mensaje);
+        return;
+    }
+
+    for (auto const &c : s.clientes)
+    {
+        enviar(c, generar_sense_body(s, c));
+        if (toca_see)
+            enviar(c, generar_see(s, c));
+    }
+}
+
+/**
+ * @brief Carga un fichero de replay: un mensaje por línea, cada sense_body abre un ciclo
+ */
+static bool cargar_replay(Servidor &s, string const &fichero)
+{
+    ifstream entrada(fichero);
+    if (!entrada)
+        return false;
+    string linea;
+    while (getline(entrada, linea))
+    {
+        if (linea.empty())
+            continue;
+        if (s.replay.empty() || linea.starts_with("(sense_body"))
+            s.replay.emplace_back();
+        s.replay.back().push_back(linea);
+    }
+    return !s.replay.empty();
+}
+
+/**
+ * @brief Percentil de un vector de latencias (se ordena en el sitio)
+ */
+static double percentil_ms(vector<int64_t> &valores, double p)
+{
+    if (valores.empty())
+        return 0;
+    size_t indice = min(valores.size() - 1, static_cast<size_t>(p * valores.size()));
+    nth_element(valores.begin(), valores.begin() + indice, valores.end());
+    return valores[indice] / 1e6;
+}
+
+static void imprimir_resumen(Servidor &s)
+{
+    cout << "Ciclos simulados: " << s.ciclo << endl;
+    for (auto &c : s.clientes)
+    {
+        printf("%s %2d (%c): ciclos %lu, comandos %lu, perdidos %lu, latencia p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+               c.equipo.c_str(), c.numero, c.lado, c.ciclos, c.comandos, c.ciclos_perdidos,
+               percentil_ms(c.latencias_ns, 0.50), percentil_ms(c.latencias_ns, 0.99),
+               percentil_ms(c.latencias_ns, 1.0));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Servidor s;
+
+    // ======================================================
+    // ARGUMENTOS
+    // ======================================================
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string opcion = argv[i];
+        string valor = argv[i + 1];
+        if (opcion == "--puerto")
+            s.config.puerto = stoi(valor);
+        else if (opcion == "--ciclo-ms")
+            s.config.ciclo_ms = stoi(valor);
+        else if (opcion == "--see-cada")
+            s.config.see_cada = max(1, stoi(valor));
+        else if (opcion == "--ciclos")
+            s.config.ciclos = stoull(valor);
+        else if (opcion == "--inicio")
+            s.config.inicio = stoi(valor);
+        else if (opcion == "--replay")
+            s.config.replay = valor;
+        else
+        {
+            cout << "Uso: " << argv[0] << " [--puerto 6000] [--ciclo-ms 100] [--see-cada 1]"
+                 << " [--ciclos 0] [--inicio 20] [--replay fichero]" << endl;
+            return 1;
+        }
+    }
+    if (!s.config.replay.empty() && !cargar_replay(s, s.config.replay))
+    {
+        cout << "No se puede leer el fichero de replay " << s.config.replay << endl;
+        return 1;
+    }
+
+    // ======================================================
+    // SOCKET PRINCIPAL, TEMPORIZADOR DE CICLO Y EPOLL
+    // ======================================================
+    s.fd_principal = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(static_cast<uint16_t>(s.config.puerto));
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(s.fd_principal, reinterpret_cast<sockaddr *>(&local), sizeof(local)) < 0)
+    {
+        cout << "Error al abrir el puerto " << s.config.puerto << endl;
+        return 1;
+    }
+
+    s.temporizador_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    itimerspec periodo{};
+    periodo.it_interval.tv_sec = s.config.ciclo_ms / 1000;
+    periodo.it_interval.tv_nsec = (s.config.ciclo_ms % 1000) * 1'000'000L;
+    periodo.it_value = periodo.it_interval;
+    timerfd_settime(s.temporizador_fd, 0, &periodo, nullptr);
+
+    s.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event evento{};
+    evento.events = EPOLLIN;
+    evento.data.u32 = 0;
+    epoll_ctl(s.epoll_fd, EPOLL_CTL_ADD, s.fd_principal, &evento);
+    evento.data.u32 = UINT32_MAX;
+    epoll_ctl(s.epoll_fd, EPOLL_CTL_ADD, s.temporizador_fd, &evento);
+
+    signal(SIGINT, terminar);
+    signal(SIGTERM, terminar);
+    cout << "Servidor simulado en el puerto " << s.config.puerto << ", ciclo " << s.config.ciclo_ms << " ms" << endl;
+
+    // ======================================================
+    // BUCLE PRINCIPAL
+    // ======================================================
+    char buffer[8192];
+    epoll_event eventos[32];
+    s.inicio_ciclo_ns = ahora_ns();
+
+    while (!fin_solicitado && (s.config.ciclos == 0 || static_cast<uint64_t>(s.ciclo) < s.config.ciclos))
+    {
+        int listos = epoll_wait(s.epoll_fd, eventos, 32, -1);
+        for (int e = 0; e < listos; e++)
+        {
+            uint32_t id = eventos[e].data.u32;
+            if (id == UINT32_MAX)
+            {
+                uint64_t vencimientos;
+                if (read(s.temporizador_fd, &vencimientos, sizeof(vencimientos)) > 0)
+                    nuevo_ciclo(s);
+                continue;
+            }
+
+            int fd = (id == 0) ? s.fd_principal : s.clientes[id - 1].fd;
+            sockaddr_in origen{};
+            socklen_t tam_origen = sizeof(origen);
+            ssize_t leidos;
+            while ((leidos = recvfrom(fd, buffer, sizeof(buffer), 0,
+                                      reinterpret_cast<sockaddr *>(&origen), &tam_origen)) > 0)
+            {
+                string_view mensaje(buffer, static_cast<size_t>(leidos));
+                if (id == 0)
+                    atender_init(s, mensaje, origen);
+                else
+                    atender_comando(s, s.clientes[id - 1], mensaje);
+                tam_origen = sizeof(origen);
+            }
+        }
+    }
+
+    imprimir_resumen(s);
+    for (auto &c : s.clientes)
+        close(c.fd);
+    close(s.fd_principal);
+    close(s.temporizador_fd);
+    close(s.epoll_fd);
+    return 0;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file mundo.cpp
+ * @brief Implementación del modelo persistente de jugadores
+ */
+
+#include "mundo.h"
+#include "odometria.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// Error relativo a la distancia de la posición de un jugador visto (cuantización de distancia y dirección)
+constexpr float ERROR_RELATIVO_JUGADOR = 0.03f;
+
+/// Fracción del residuo que corrige la velocidad (filtro alfa-beta)
+constexpr float GANANCIA_VELOCIDAD = 0.3f;
+
+/// Distancia, en desviaciones típicas, por encima de la cual una observación reinicia el hueco
+constexpr float UMBRAL_ASOCIACION = 3.0f;
+
+/**
+ * @brief Error previsto (m) de un hueco en un ciclo
+ */
+static float error_previsto(MundoJugadores const &mundo, int hueco, int tiempo)
+{
+    return mundo.error[hueco] + CRECIMIENTO_ERROR_JUGADOR * static_cast<float>(tiempo - mundo.ultima_vista[hueco]);
+}
+
+/**
+ * @brief Posición prevista de un jugador en un ciclo, en O(1)
+ *
+ * Se extrapola con la velocidad estimada hasta HORIZONTE_PREDICCION_JUGADOR
+ * ciclos; más allá el jugador se supone quieto.
+ *
+ * @param mundo Modelo de jugadores
+ * @param hueco Hueco del jugador (hueco_jugador)
+ * @param tiempo Ciclo de la predicción
+ */
+Punto posicion_jugador_en(MundoJugadores const &mundo, int hueco, int tiempo)
+{
+    float ciclos = static_cast<float>(clamp(tiempo - mundo.ultima_vista[hueco], 0, HORIZONTE_PREDICCION_JUGADOR));
+    return {mundo.x[hueco] + mundo.vx[hueco] * ciclos, mundo.y[hueco] + mundo.vy[hueco] * ciclos};
+}
+
+/**
+ * @brief Confianza (0..1) de la posición de un jugador en un ciclo
+ *
+ * Mismo convenio que la pose propia: 1 / (1 + error en metros).
+ */
+float confianza_jugador(MundoJugadores const &mundo, int hueco, int tiempo)
+{
+    if (mundo.ultima_vista[hueco] < 0)
+        return 0.0f;
+    return confianza_desde_error(error_previsto(mundo, hueco, tiempo));
+}
+
+/**
+ * @brief Fusiona una observación en un hueco (filtro alfa-beta)
+ *
+ * La ganancia de la posición sale de los errores previsto y observado; la
+ * velocidad se corrige con una fracción del residuo por ciclo. Si el hueco
+ * nunca se ha visto, se vio hace demasiado o la observación no encaja, se
+ * reinicia en ella.
+ */
+static void observar(MundoJugadores &mundo, int hueco, int tiempo, float x, float y, float error)
+{
+    error = max(error, ERROR_MINIMO_ODOMETRIA);
+    int ciclos = tiempo - mundo.ultima_vista[hueco];
+    if (mundo.ultima_vista[hueco] >= 0 && ciclos > 0 && ciclos <= HORIZONTE_PREDICCION_JUGADOR)
+    {
+        Punto previsto = posicion_jugador_en(mundo, hueco, tiempo);
+        float error_prev = error_previsto(mundo, hueco, tiempo);
+        float rx = x - previsto.x, ry = y - previsto.y;
+        float varianza_prev = error_prev * error_prev, varianza_obs = error * error;
+        if (rx * rx + ry * ry < UMBRAL_ASOCIACION * UMBRAL_ASOCIACION * (varianza_prev + varianza_obs))
+        {
+            float ganancia = varianza_prev / (varianza_prev + varianza_obs);
+            mundo.x[hueco] = previsto.x + ganancia * rx;
+            mundo.y[hueco] = previsto.y + ganancia * ry;
+            mundo.vx[hueco] += GANANCIA_VELOCIDAD * ganancia * rx / static_cast<float>(ciclos);
+            mundo.vy[hueco] += GANANCIA_VELOCIDAD * ganancia * ry / static_cast<float>(ciclos);
+            float velocidad = hypot(mundo.vx[hueco], mundo.vy[hueco]);
+            if (velocidad > VELOCIDAD_MAX_JUGADOR)
+            {
+                mundo.vx[hueco] *= VELOCIDAD_MAX_JUGADOR / velocidad;
+                mundo.vy[hueco] *= VELOCIDAD_MAX_JUGADOR / velocidad;
+            }
+            mundo.error[hueco] = sqrt(varianza_prev * varianza_obs / (varianza_prev + varianza_obs));
+            mundo.ultima_vista[hueco] = tiempo;
+            return;
+        }
+    }
+    mundo.x[hueco] = x;
+    mundo.y[hueco] = y;
+    mundo.vx[hueco] = 0;
+    mundo.vy[hueco] = 0;
+    mundo.error[hueco] = error;
+    mundo.ultima_vista[hueco] = tiempo;
+}
+
+/**
+ * @brief Hueco para un jugador visto sin dorsal
+ *
+ * Entre los huecos de su equipo no vistos en este "see" y aún recordados
+ * (confianza >= CONFIANZA_MIN_MUNDO), el de posición prevista más cercana si
+ * encaja con su error. Si ninguno encaja, un hueco libre: el que lleve más
+ * tiempo sin verse entre los nunca vistos u olvidados.
+ *
+ * @return Hueco, o -1 si todos los del equipo están ocupados
+ */
+static int hueco_sin_dorsal(MundoJugadores const &mundo, bool companero, int tiempo, float x, float y,
+                            float error)
+{
+    int primero = hueco_jugador(companero, 1);
+    int mejor = -1, libre = -1;
+    float mejor_d2 = 0;
+    for (int h = primero; h < primero + JUGADORES_POR_EQUIPO; h++)
+    {
+        if (mundo.ultima_vista[h] == tiempo)
+            continue;
+        if (confianza_jugador(mundo, h, tiempo) < CONFIANZA_MIN_MUNDO)
+        {
+            if (libre == -1 || mundo.ultima_vista[h] < mundo.ultima_vista[libre])
+                libre = h;
+            continue;
+        }
+        Punto previsto = posicion_jugador_en(mundo, h, tiempo);
+        float error_prev = error_previsto(mundo, h, tiempo);
+        float dx = x - previsto.x, dy = y - previsto.y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 < UMBRAL_ASOCIACION * UMBRAL_ASOCIACION * (error_prev * error_prev + error * error) &&
+            (mejor == -1 || d2 < mejor_d2))
+        {
+            mejor = h;
+            mejor_d2 = d2;
+        }
+    }
+    return (mejor != -1) ? mejor : libre;
+}
+
+/**
+ * @brief Incorpora los jugadores vistos del último "see" al modelo persistente
+ *
+ * Los jugadores con dorsal van a su hueco. Los vistos sin dorsal (lejanos),
+ * compañeros o rivales, van al hueco de su equipo que indique
+ * hueco_sin_dorsal; si el equipo no tiene ninguno disponible, se descartan.
+ *
+ * @param tiempo Ciclo del "see"
+ * @param datos Estructura con los jugadores vistos, la pose y el modelo
+ */
+void actualizar_mundo(int tiempo, Game_data &datos)
+{
+    Jugadores_Vistos const &vistos = datos.jugadores_vistos;
+    MundoJugadores &mundo = datos.mundo;
+    Player const &jugador = datos.jugador;
+    if (!vistos.en_campo || tiempo < mundo.tiempo)
+        return;
+    mundo.tiempo = tiempo;
+
+    // El propio jugador, con su pose
+    float error_pose = error_posicion_jugador(jugador);
+    if (jugador.jugador_numero >= 1 && jugador.jugador_numero <= JUGADORES_POR_EQUIPO)
+        observar(mundo, hueco_jugador(true, jugador.jugador_numero), tiempo, jugador.x_absoluta,
+                 jugador.y_absoluta, error_pose);
+
+    // Error de orientación en radianes: desplaza lateralmente en proporción a la distancia
+    float error_angulo = min(jugador.error_orientacion, 90.0f) * static_cast<float>(M_PI / 180);
+    for (int i = 0; i < vistos.num; i++)
+    {
+        if (vistos.numero[i] < 1 || vistos.numero[i] > JUGADORES_POR_EQUIPO)
+            continue;
+        float error = error_pose + vistos.distancia[i] * (ERROR_RELATIVO_JUGADOR + error_angulo);
+        observar(mundo, hueco_jugador(vistos.companero[i], vistos.numero[i]), tiempo, vistos.x[i], vistos.y[i],
+                 error);
+    }
+
+    // Sin dorsal: al hueco más cercano que encaje o, si no, a uno libre de su equipo
+    for (int i = 0; i < vistos.num; i++)
+    {
+        if (vistos.numero[i] != 0)
+            continue;
+        float error = error_pose + vistos.distancia[i] * (ERROR_RELATIVO_JUGADOR + error_angulo);
+        int hueco = hueco_sin_dorsal(mundo, vistos.companero[i], tiempo, vistos.x[i], vistos.y[i], error);
+        if (hueco != -1)
+            observar(mundo, hueco, tiempo, vistos.x[i], vistos.y[i], error);
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ * @file mundo.h
+ * @brief Archivo de cabecera del modelo persistente de jugadores
+ *
+ * Game_data::jugadores_vistos solo contiene lo que aparece en el último
+ * "see". Este módulo acumula esas observaciones, ya proyectadas al campo, en
+ * un hueco por jugador con su último ciclo visto, una velocidad estimada y un
+ * error que crece mientras no se vuelve a ver. Así la decisión puede tener en
+ * cuenta a jugadores que quedan detrás sin girarse a buscarlos.
+ */
+
+#ifndef MUNDO_H
+#define MUNDO_H
+
+// Inclusión de dependencias
+#include "structs.h"
+
+using namespace std;
+
+/// Crecimiento del error (m) por cada ciclo sin ver a un jugador
+constexpr float CRECIMIENTO_ERROR_JUGADOR = 0.6f;
+
+/// Ciclos durante los que se extrapola con la velocidad; después se supone quieto
+constexpr int HORIZONTE_PREDICCION_JUGADOR = 10;
+
+/// Confianza mínima para que la decisión tenga en cuenta a un jugador no visible
+constexpr float CONFIANZA_MIN_MUNDO = 0.2f;
+
+/**
+ * @brief Hueco de un jugador en MundoJugadores
+ *
+ * @param companero true si es de nuestro equipo
+ * @param dorsal Dorsal 1-11
+ */
+constexpr int hueco_jugador(bool companero, int dorsal)
+{
+    return (companero ? 0 : JUGADORES_POR_EQUIPO) + dorsal - 1;
+}
+
+/**
+ * @brief Incorpora los jugadores vistos del último "see" al modelo persistente
+ *
+ * Requiere que proyectar_observaciones haya dejado las posiciones en el campo
+ * (Jugadores_Vistos::en_campo); si no, no hace nada. El propio jugador se
+ * actualiza con su pose. Un jugador visto sin dorsal puede ocupar el hueco
+ * libre de otro dorsal de su equipo hasta que se le vuelva a ver con el suyo.
+ *
+ * @param tiempo Ciclo del "see"
+ * @param datos Estructura con los jugadores vistos, la pose y el modelo
+ */
+void actualizar_mundo(int tiempo, Game_data &datos);
+
+/**
+ * @brief Posición prevista de un jugador en un ciclo, en O(1)
+ *
+ * @param mundo Modelo de jugadores
+ * @param hueco Hueco del jugador (hueco_jugador)
+ * @param tiempo Ciclo de la predicción
+ */
+Punto posicion_jugador_en(MundoJugadores const &mundo, int hueco, int tiempo);
+
+/**
+ * @brief Confianza (0..1) de la posición de un jugador en un ciclo
+ *
+ * @return 0 si nunca se ha visto; baja con los ciclos transcurridos desde entonces
+ */
+float confianza_jugador(MundoJugadores const &mundo, int hueco, int tiempo);
+
+#endif // MUNDO_H
@@ -0,0 +1,47 @@
+/**
+ * @file numeros.cpp
+ * @brief Implementación de la lectura de campos numéricos del protocolo
+ */
+
+#include "numeros.h"
+
+#include <charconv>
+#include <system_error>
+
+/**
+ * @brief Traduce el resultado de from_chars a ErrorNumero
+ */
+static ErrorNumero resultado_lectura(from_chars_result resultado, string_view texto)
+{
+    if (resultado.ec == errc::invalid_argument)
+        return ErrorNumero::Formato;
+    if (resultado.ec == errc::result_out_of_range)
+        return ErrorNumero::Rango;
+    if (resultado.ptr != texto.data() + texto.size())
+        return ErrorNumero::Sobrante;
+    return ErrorNumero::Ninguno;
+}
+
+ErrorNumero leer_float(string_view texto, float &valor)
+{
+    if (texto.empty())
+        return ErrorNumero::Vacio;
+
+    float leido;
+    ErrorNumero error = resultado_lectura(from_chars(texto.data(), texto.data() + texto.size(), leido), texto);
+    if (error == ErrorNumero::Ninguno)
+        valor = leido;
+    return error;
+}
+
+ErrorNumero leer_entero(string_view texto, int &valor)
+{
+    if (texto.empty())
+        return ErrorNumero::Vacio;
+
+    int leido;
+    ErrorNumero error = resultado_lectura(from_chars(texto.data(), texto.data() + texto.size(), leido), texto);
+    if (error == ErrorNumero::Ninguno)
+        valor = leido;
+    return error;
+}
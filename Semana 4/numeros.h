@@ -0,0 +1,48 @@
+/**
+ * @file numeros.h
+ * @brief Archivo de cabecera de la lectura de campos numéricos del protocolo
+ *
+ * Convierte los números de los mensajes del servidor (distancias, ángulos,
+ * tiempos, dorsales) directamente desde el buffer de recepción con
+ * std::from_chars: sin copiar a std::string, sin depender del locale y sin
+ * excepciones. Los errores se devuelven como código.
+ */
+
+#ifndef NUMEROS_H
+#define NUMEROS_H
+
+// Inclusión de dependencias
+#include <cstdint>
+#include <string_view>
+
+using namespace std;
+
+/// Resultado de la lectura de un campo numérico
+enum class ErrorNumero : uint8_t
+{
+    Ninguno,     ///< Lectura correcta
+    Vacio,       ///< El campo no tiene caracteres
+    Formato,     ///< El campo no empieza por un número
+    Rango,       ///< El número no cabe en el tipo de destino
+    Sobrante     ///< Hay caracteres después del número
+};
+
+/**
+ * @brief Lee un campo completo como float (ej: "12.5", "-3", "1e-2")
+ *
+ * @param texto Campo a leer (todo él debe ser el número)
+ * @param valor Destino; no se modifica si hay error
+ * @return ErrorNumero::Ninguno si la lectura es correcta
+ */
+ErrorNumero leer_float(string_view texto, float &valor);
+
+/**
+ * @brief Lee un campo completo como entero en base 10 (ej: "42", "-7")
+ *
+ * @param texto Campo a leer (todo él debe ser el número)
+ * @param valor Destino; no se modifica si hay error
+ * @return ErrorNumero::Ninguno si la lectura es correcta
+ */
+ErrorNumero leer_entero(string_view texto, int &valor);
+
+#endif // NUMEROS_H
@@ -0,0 +1,197 @@
+/**
+ * @file odometria.cpp
+ * @brief Implementación de la odometría (navegación a estima con sense_body)
+ */
+
+#include "odometria.h"
+#include "numeros.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Decodifica un sense_body ya tokenizado
+ *
+ * Solo se leen los campos que usa la odometría: stamina (resistencia y
+ * effort), speed y head_angle. El resto de listas se ignora.
+ *
+ * @param arbol Árbol del mensaje
+ * @param sense Salida: valores leídos (valido = false si el mensaje no es un sense_body)
+ * @return true si el mensaje era un sense_body con tiempo válido
+ */
+bool decodificar_sense_body(ArbolSexp const &arbol, SenseBody &sense)
+{
+    sense.valido = false;
+    if (arbol.nodos.empty() || texto_hijo(arbol, 0, 0) != "sense_body")
+        return false;
+    if (leer_entero(texto_hijo(arbol, 0, 1), sense.tiempo) != ErrorNumero::Ninguno)
+        return false;
+
+    for (int nodo = hijo(arbol, 0, 2); nodo != -1; nodo = arbol.nodos[nodo].siguiente)
+    {
+        if (!arbol.nodos[nodo].es_lista)
+            continue;
+        string_view nombre = texto_hijo(arbol, nodo, 0);
+        if (nombre == "stamina") // (stamina 8000 1 130600)
+        {
+            leer_float(texto_hijo(arbol, nodo, 1), sense.stamina);
+            leer_float(texto_hijo(arbol, nodo, 2), sense.esfuerzo);
+        }
+        else if (nombre == "speed") // (speed 0.5 -12)
+        {
+            leer_float(texto_hijo(arbol, nodo, 1), sense.velocidad);
+            leer_float(texto_hijo(arbol, nodo, 2), sense.direccion_velocidad);
+        }
+        else if (nombre == "head_angle") // (head_angle 30)
+        {
+            leer_float(texto_hijo(arbol, nodo, 1), sense.angulo_cuello);
+        }
+    }
+    sense.valido = true;
+    return true;
+}
+
+/**
+ * @brief Desviación típica (m) de la posición propia a partir de su confianza
+ *
+ * @return Error de la posición, o un valor negativo si la pose no se conoce
+ */
+float error_posicion_jugador(Player const &jugador)
+{
+    if (jugador.confianza_posicion <= 0 || jugador.x_absoluta == 999.0f)
+        return -1.0f;
+    return 1 / jugador.confianza_posicion - 1;
+}
+
+/**
+ * @brief Confianza (0..1) que corresponde a un error de posición en metros
+ */
+float confianza_desde_error(float error)
+{
+    return 1 / (1 + error);
+}
+
+/**
+ * @brief Mueve la posición un paso y acumula en varianza el error de ese paso
+ *
+ * El servidor perturba el movimiento con un ruido uniforme proporcional a su
+ * módulo (varianza (r·|m|)²/3); el error de orientación desvía además la
+ * dirección en la que se aplica.
+ */
+static void mover(Player &jugador, float mx, float my, float &varianza)
+{
+    jugador.x_absoluta += mx;
+    jugador.y_absoluta += my;
+    float m2 = mx * mx + my * my;
+    float error_angulo = min(jugador.error_orientacion, 90.0f) * static_cast<float>(M_PI / 180);
+    varianza += RUIDO_JUGADOR * RUIDO_JUGADOR * m2 / 3 + error_angulo * error_angulo * m2 +
+                ERROR_MINIMO_ODOMETRIA * ERROR_MINIMO_ODOMETRIA;
+}
+
+/**
+ * @brief Avanza la pose propia hasta el ciclo del sense_body
+ *
+ * La velocidad del sense_body es la que queda tras el decaimiento del ciclo,
+ * así que el último paso fue velocidad / decay. Los ciclos intermedios sin
+ * sense_body se cubren con la velocidad anterior más los dash enviados.
+ *
+ * @param sense sense_body recibido
+ * @param datos Estructura con la pose del jugador y su odometría
+ */
+void actualizar_odometria(SenseBody const &sense, Game_data &datos)
+{
+    if (!sense.valido)
+        return;
+    Odometria &odometria = datos.odometria;
+    Player &jugador = datos.jugador;
+    odometria.stamina = sense.stamina;
+    odometria.esfuerzo = sense.esfuerzo;
+
+    // El ángulo del cuello es exacto: la vista se rehace desde el cuerpo
+    jugador.angulo_cuello = sense.angulo_cuello;
+    bool orientado = jugador.orientacion_cuerpo != 999.0f;
+    float vx = 0, vy = 0;
+    if (orientado)
+    {
+        jugador.orientacion_cuello = static_cast<float>(
+            remainder(jugador.orientacion_cuerpo - jugador.angulo_cuello, 360.0));
+        // El servidor da la dirección respecto a la vista (cuerpo + cuello) y en
+        // sentido horario: en el campo es cuello - direccion
+        float angulo = (jugador.orientacion_cuello - sense.direccion_velocidad) * static_cast<float>(M_PI / 180);
+        vx = sense.velocidad * cos(angulo);
+        vy = sense.velocidad * sin(angulo);
+    }
+
+    float error = error_posicion_jugador(jugador);
+    if (error >= 0 && orientado && odometria.tiempo >= 0 && sense.tiempo > odometria.tiempo)
+    {
+        float varianza = error * error;
+
+        // Ciclos sin sense_body: velocidad prevista con los dash enviados
+        float px = odometria.vx + odometria.ax, py = odometria.vy + odometria.ay;
+        for (int ciclo = odometria.tiempo + 1; ciclo < sense.tiempo; ciclo++)
+        {
+            float velocidad = hypot(px, py);
+            if (velocidad > VELOCIDAD_MAX_JUGADOR)
+            {
+                px *= VELOCIDAD_MAX_JUGADOR / velocidad;
+                py *= VELOCIDAD_MAX_JUGADOR / velocidad;
+            }
+            mover(jugador, px, py, varianza);
+            px *= DECAIMIENTO_JUGADOR;
+            py *= DECAIMIENTO_JUGADOR;
+        }
+
+        // Último ciclo: lo recorrido es la velocidad medida antes de decaer
+        mover(jugador, vx / DECAIMIENTO_JUGADOR, vy / DECAIMIENTO_JUGADOR, varianza);
+        jugador.confianza_posicion = confianza_desde_error(sqrt(varianza));
+    }
+
+    odometria.vx = vx;
+    odometria.vy = vy;
+    odometria.ax = 0;
+    odometria.ay = 0;
+    odometria.tiempo = sense.tiempo;
+}
+
+/**
+ * @brief Registra un dash enviado: acelera al jugador en el siguiente ciclo
+ *
+ * La potencia positiva está limitada por la resistencia disponible y se
+ * aprovecha en la proporción del effort. A diferencia de la velocidad del
+ * sense_body, la dirección del dash es respecto al cuerpo.
+ */
+void registrar_dash(Game_data &datos, float potencia, float direccion)
+{
+    Player const &jugador = datos.jugador;
+    Odometria &odometria = datos.odometria;
+    if (jugador.orientacion_cuerpo == 999.0f)
+        return;
+    potencia = clamp(potencia, -100.0f, 100.0f);
+    if (odometria.tiempo >= 0 && potencia > 0)
+        potencia = min(potencia, odometria.stamina);
+    float aceleracion = potencia * TASA_POTENCIA_DASH * odometria.esfuerzo;
+    float angulo = (jugador.orientacion_cuerpo - direccion) * static_cast<float>(M_PI / 180);
+    odometria.ax += aceleracion * cos(angulo);
+    odometria.ay += aceleracion * sin(angulo);
+}
+
+/**
+ * @brief Registra un turn enviado: gira cuerpo y vista con la inercia del servidor
+ *
+ * El momento positivo gira en sentido horario, es decir, resta a la
+ * orientación del campo. El ruido del servidor sobre el giro aumenta el error
+ * de orientación.
+ */
+void registrar_turn(Game_data &datos, float momento)
+{
+    Player &jugador = datos.jugador;
+    if (jugador.orientacion_cuerpo == 999.0f)
+        return;
+    float velocidad = hypot(datos.odometria.vx, datos.odometria.vy);
+    float giro = clamp(momento, -180.0f, 180.0f) / (1 + INERCIA_GIRO * velocidad);
+    jugador.orientacion_cuerpo = static_cast<float>(remainder(jugador.orientacion_cuerpo - giro, 360.0));
+    jugador.orientacion_cuello = static_cast<float>(
+        remainder(jugador.orientacion_cuerpo - jugador.angulo_cuello, 360.0));
+    jugador.error_orientacion = hypot(jugador.error_orientacion, RUIDO_JUGADOR * abs(giro) / sqrt(3.0f));
+}
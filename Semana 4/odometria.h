@@ -0,0 +1,106 @@
+/**
+ * @file odometria.h
+ * @brief Archivo de cabecera de la odometría (navegación a estima con sense_body)
+ *
+ * El servidor envía un sense_body al empezar cada ciclo con la velocidad del
+ * jugador respecto al cuerpo, el ángulo del cuello y la resistencia. Con eso
+ * y con los dash/turn enviados la pose avanza cada ciclo aunque no llegue un
+ * "see" o no haya flags a la vista, y la localización por flags la corrige
+ * cuando llega.
+ */
+
+#ifndef ODOMETRIA_H
+#define ODOMETRIA_H
+
+// Inclusión de dependencias
+#include "structs.h"
+#include "utilities.h"
+
+using namespace std;
+
+/// Decaimiento de la velocidad del jugador por ciclo (player_decay del servidor)
+constexpr float DECAIMIENTO_JUGADOR = 0.4f;
+
+/// Velocidad máxima del jugador en metros/ciclo (player_speed_max del servidor)
+constexpr float VELOCIDAD_MAX_JUGADOR = 1.05f;
+
+/// Aceleración de un dash de potencia 1 (dash_power_rate del servidor)
+constexpr float TASA_POTENCIA_DASH = 0.006f;
+
+/// Inercia del giro: el turn efectivo es momento / (1 + inercia · velocidad) (inertia_moment)
+constexpr float INERCIA_GIRO = 5.0f;
+
+/// Ruido relativo del servidor sobre el movimiento y los giros del jugador (player_rand)
+constexpr float RUIDO_JUGADOR = 0.1f;
+
+/// Error mínimo (m) que se añade a la posición en cada ciclo de navegación a estima
+constexpr float ERROR_MINIMO_ODOMETRIA = 0.02f;
+
+/**
+ * @brief Contenido de un sense_body
+ *
+ * @note Formato: "(sense_body 4 (view_mode high normal) (stamina 8000 1 130600)
+ *       (speed 0.5 -12) (head_angle 0) ...)"
+ */
+struct SenseBody
+{
+    bool valido;                ///< El último mensaje decodificado era un sense_body
+    int tiempo;                 ///< Ciclo del sense_body
+    float stamina;              ///< Resistencia disponible
+    float esfuerzo;             ///< effort
+    float velocidad;            ///< Módulo de la velocidad (m/ciclo)
+    float direccion_velocidad;  ///< Dirección de la velocidad respecto a la vista (grados, horario)
+    float angulo_cuello;        ///< Ángulo del cuello respecto al cuerpo (grados, horario)
+
+    /**
+     * @brief Constructor por defecto (sin sense_body)
+     */
+    SenseBody()
+        : valido(false), tiempo(-1), stamina(0.0f), esfuerzo(1.0f), velocidad(0.0f),
+        direccion_velocidad(0.0f), angulo_cuello(0.0f) {}
+};
+
+/**
+ * @brief Decodifica un sense_body ya tokenizado
+ *
+ * @param arbol Árbol del mensaje
+ * @param sense Salida: valores leídos (valido = false si el mensaje no es un sense_body)
+ * @return true si el mensaje era un sense_body con tiempo válido
+ */
+bool decodificar_sense_body(ArbolSexp const &arbol, SenseBody &sense);
+
+/**
+ * @brief Avanza la pose propia hasta el ciclo del sense_body
+ *
+ * Cada ciclo transcurrido mueve al jugador lo que indica la velocidad del
+ * sense_body (o, si faltan ciclos, la prevista con los dash enviados) y hace
+ * crecer el error de la posición. El ángulo del cuello se toma tal cual.
+ *
+ * @param sense sense_body recibido
+ * @param datos Estructura con la pose del jugador y su odometría
+ */
+void actualizar_odometria(SenseBody const &sense, Game_data &datos);
+
+/**
+ * @brief Registra un dash enviado: acelera al jugador en el siguiente ciclo
+ */
+void registrar_dash(Game_data &datos, float potencia, float direccion);
+
+/**
+ * @brief Registra un turn enviado: gira cuerpo y vista con la inercia del servidor
+ */
+void registrar_turn(Game_data &datos, float momento);
+
+/**
+ * @brief Desviación típica (m) de la posición propia a partir de su confianza
+ *
+ * @return Error de la posición, o un valor negativo si la pose no se conoce
+ */
+float error_posicion_jugador(Player const &jugador);
+
+/**
+ * @brief Confianza (0..1) que corresponde a un error de posición en metros
+ */
+float confianza_desde_error(float error);
+
+#endif // ODOMETRIA_H
@@ -0,0 +1,125 @@
+/**
+ * @file percepcion.cpp
+ * @brief Implementación del decodificador de mensajes "see"
+ */
+
+#include "percepcion.h"
+
+#include "numeros.h"
+
+/**
+ * @brief Indica si un átomo entre comillas ("Equipo") es el nombre dado
+ */
+static bool es_nombre_equipo(string_view atomo, string const &nombre)
+{
+    return atomo.size() == nombre.size() + 2 && atomo.front() == '"' && atomo.back() == '"' &&
+           atomo.substr(1, nombre.size()) == nombre;
+}
+
+/**
+ * @brief Clasifica un objeto a partir de su lista de nombre
+ *
+ * @param arbol Mensaje tokenizado
+ * @param nombre Índice de la lista del nombre (ej: (p "Equipo" 3 goalie))
+ * @param nombre_equipo Nombre de nuestro equipo
+ * @param objeto Objeto de salida (tipo, flag, número y portero)
+ */
+static void clasificar(ArbolSexp const &arbol, int nombre, string const &nombre_equipo, ObjetoVisto &objeto)
+{
+    string_view clase = texto_hijo(arbol, nombre, 0);
+    objeto.tipo = TipoObjeto::Otro;
+    objeto.flag = -1;
+    if (clase.size() != 1)
+        return;
+
+    switch (clase[0])
+    {
+    case 'b': objeto.tipo = TipoObjeto::Balon; break;
+    case 'f':
+        objeto.tipo = TipoObjeto::Flag;
+        objeto.flag = indice_flag(objeto.nombre);
+        break;
+    case 'g': objeto.tipo = TipoObjeto::Porteria; break;
+    case 'l': objeto.tipo = TipoObjeto::Linea; break;
+    case 'p':
+        // Jugadores con equipo: (p "Equipo" [numero [goalie]]); de lejos llega sin dorsal (numero = 0)
+        if (arbol.nodos[nombre].num_hijos >= 2)
+        {
+            objeto.tipo = es_nombre_equipo(texto_hijo(arbol, nombre, 1), nombre_equipo)
+                              ? TipoObjeto::Companero
+                              : TipoObjeto::Contrario;
+            if (arbol.nodos[nombre].num_hijos >= 3)
+            {
+                leer_entero(texto_hijo(arbol, nombre, 2), objeto.numero);
+                objeto.portero = texto_hijo(arbol, nombre, 3) == "goalie";
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Decodifica un mensaje ya tokenizado en una observación
+ *
+ * @param arbol Mensaje tokenizado
+ * @param nombre_equipo Nombre de nuestro equipo (distingue compañeros de contrarios)
+ * @param observacion Observación de salida
+ * @return true si el mensaje era un "see"
+ */
+bool decodificar_see(ArbolSexp const &arbol, string const &nombre_equipo, ObservacionSee &observacion)
+{
+    observacion.objetos.clear();
+    observacion.balon = -1;
+    observacion.valida = texto_hijo(arbol, 0, 0) == "see";
+    if (!observacion.valida)
+        return false;
+
+    observacion.tiempo = -1;
+    leer_entero(texto_hijo(arbol, 0, 1), observacion.tiempo);
+
+    // (see Tiempo ((nombre) valores...) ((nombre) valores...) ...)
+    for (int o = hijo(arbol, 0, 2); o != -1; o = arbol.nodos[o].siguiente)
+    {
+        NodoSexp const &nodo = arbol.nodos[o];
+        if (!nodo.es_lista || nodo.num_hijos == 0 || !arbol.nodos[nodo.primer_hijo].es_lista)
+            continue;
+
+        ObjetoVisto objeto{};
+        objeto.nombre = arbol.nodos[nodo.primer_hijo].texto;
+        clasificar(arbol, nodo.primer_hijo, nombre_equipo, objeto);
+
+        // Valores numéricos tras el nombre; los jugadores pueden terminar con marcadores (t, k)
+        float valores[6];
+        int leidos = 0;
+        bool valores_correctos = true;
+        for (int h = arbol.nodos[nodo.primer_hijo].siguiente; h != -1 && leidos < 6; h = arbol.nodos[h].siguiente)
+        {
+            ErrorNumero error = leer_float(arbol.nodos[h].texto, valores[leidos]);
+            if (error == ErrorNumero::Formato)
+                break;
+            if (error != ErrorNumero::Ninguno)
+            {
+                valores_correctos = false;
+                break;
+            }
+            leidos++;
+        }
+        if (!valores_correctos)
+            continue;
+
+        // Con un único valor solo se conoce la dirección
+        objeto.num_valores = leidos;
+        float *destino[] = {&objeto.distancia, &objeto.direccion, &objeto.cambio_distancia,
+                            &objeto.cambio_direccion, &objeto.direccion_cuerpo, &objeto.direccion_cabeza};
+        int primero = (leidos == 1) ? 1 : 0;
+        for (int v = 0; v < leidos; v++)
+            *destino[primero + v] = valores[v];
+
+        if (objeto.tipo == TipoObjeto::Balon)
+            observacion.balon = static_cast<int>(observacion.objetos.size());
+        observacion.objetos.push_back(objeto);
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file percepcion.h
+ * @brief Archivo de cabecera del decodificador de mensajes "see"
+ *
+ * Recorre una sola vez el árbol de un mensaje "see" y clasifica cada objeto
+ * visto (balón, flag, portería, línea, compañero o contrario) en una
+ * observación tipada. Todos los consumidores del ciclo (balón, porterías,
+ * jugadores y localización) leen de esa observación en lugar de volver a
+ * recorrer el mensaje.
+ */
+
+#ifndef PERCEPCION_H
+#define PERCEPCION_H
+
+// Inclusión de dependencias
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tabla_flags.h"
+#include "utilities.h"
+
+using namespace std;
+
+/// Clase de objeto visto en un mensaje "see"
+enum class TipoObjeto : uint8_t
+{
+    Balon,       ///< (b)
+    Flag,        ///< (f ...)
+    Porteria,    ///< (g l) / (g r)
+    Linea,       ///< (l ...)
+    Companero,   ///< (p "NuestroEquipo" ...)
+    Contrario,   ///< (p "OtroEquipo" ...)
+    Otro         ///< Jugador sin equipo u objeto cercano sin nombre ((p), (B), (F), (P)...)
+};
+
+/**
+ * @brief Objeto visto: nombre y valores ya convertidos a número
+ *
+ * Formato: ((nombre) distancia direccion [cambio_dist cambio_dir [cuerpo cabeza]] ...).
+ * Los valores ausentes quedan a 0; num_valores indica cuántos había. El
+ * nombre es una vista sobre el mensaje original.
+ */
+struct ObjetoVisto
+{
+    TipoObjeto tipo;
+    string_view nombre;             ///< Lista del nombre completa (ej: "(f g r b)")
+    int flag;                       ///< Índice en TABLA_FLAGS (-1 si no es un flag conocido)
+    int numero;                     ///< Dorsal (0 si el jugador se ve demasiado lejos para leerlo)
+    bool portero;                   ///< El jugador lleva la marca goalie
+    int num_valores;                ///< Valores numéricos leídos tras el nombre (máx. 6)
+    float distancia;
+    float direccion;
+    float cambio_distancia;
+    float cambio_direccion;
+    float direccion_cuerpo;
+    float direccion_cabeza;
+};
+
+/**
+ * @brief Observación de un ciclo: todos los objetos de un "see" ya clasificados
+ *
+ * El vector de objetos se reutiliza entre ciclos, así que decodificar no
+ * reserva memoria en régimen estable.
+ */
+struct ObservacionSee
+{
+    bool valida;                    ///< El último mensaje decodificado era un "see"
+    int tiempo;                     ///< Tiempo de simulación del "see"
+    int balon;                      ///< Índice del balón en objetos (-1 si no se ve)
+    vector<ObjetoVisto> objetos;    ///< Objetos en el orden del mensaje
+
+    /**
+     * @brief Constructor por defecto (sin observación)
+     */
+    ObservacionSee()
+        : valida(false), tiempo(-1), balon(-1), objetos() {}
+};
+
+/**
+ * @brief Resultado de un manejador de percepción (handle_ball, handle_porteria...)
+ *
+ * Los manejadores actualizan el modelo del mundo en su sitio y solo devuelven
+ * este resumen, que cabe en un registro.
+ */
+struct EstadoPercepcion
+{
+    bool encontrado;    ///< Se ha visto al menos un objeto de los que sigue el manejador
+    int num_objetos;    ///< Cuántos objetos de ese tipo se han aprovechado
+};
+
+/**
+ * @brief Decodifica un mensaje ya tokenizado en una observación
+ *
+ * Si el mensaje no es un "see", la observación queda marcada como no válida.
+ *
+ * @param arbol Mensaje tokenizado
+ * @param nombre_equipo Nombre de nuestro equipo (distingue compañeros de contrarios)
+ * @param observacion Observación de salida
+ * @return true si el mensaje era un "see"
+ */
+bool decodificar_see(ArbolSexp const &arbol, string const &nombre_equipo, ObservacionSee &observacion);
+
+#endif // PERCEPCION_H
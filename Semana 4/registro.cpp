@@ -0,0 +1,191 @@
+/**
+ * @file registro.cpp
+ * @brief Implementación del registro binario de tráfico con el servidor
+ */
+
+#include "registro.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// Identificador al comienzo de todo fichero de registro
+static constexpr char MAGICO[8] = {'R', 'C', 'S', 'S', 'L', 'O', 'G', '1'};
+
+/// Tamaño del buffer de escritura antes de volcar a disco
+static constexpr size_t TAM_BLOQUE_ESCRITURA = 64 * 1024;
+
+/**
+ * @brief Redondea al siguiente múltiplo de 8 (alineación de las cabeceras)
+ */
+static size_t alinear(size_t n)
+{
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+/**
+ * @brief Escribe en disco todo lo pendiente del grabador
+ */
+static void volcar(Grabador &grabador)
+{
+    size_t escrito = 0;
+    while (escrito < grabador.pendiente.size())
+    {
+        ssize_t n = write(grabador.fd, grabador.pendiente.data() + escrito, grabador.pendiente.size() - escrito);
+        if (n <= 0)
+            break;
+        escrito += static_cast<size_t>(n);
+    }
+    grabador.pendiente.clear();
+}
+
+/**
+ * @brief Crea (o trunca) un fichero de registro y escribe su cabecera
+ *
+ * @param grabador Grabador a inicializar
+ * @param ruta Ruta del fichero
+ * @return true si el fichero se ha creado
+ */
+bool abrir_grabador(Grabador &grabador, string const &ruta)
+{
+    grabador.fd = open(ruta.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (grabador.fd < 0)
+        return false;
+    grabador.pendiente.reserve(TAM_BLOQUE_ESCRITURA + sizeof(CabeceraRegistro) + 8192);
+    grabador.pendiente.insert(grabador.pendiente.end(), MAGICO, MAGICO + sizeof(MAGICO));
+    return true;
+}
+
+/**
+ * @brief Añade un registro al fichero
+ *
+ * @param grabador Grabador activo
+ * @param sentido Recibido o enviado
+ * @param instante_ns Marca de tiempo del mensaje
+ * @param contenido Bytes del mensaje
+ */
+void grabar(Grabador &grabador, Sentido sentido, int64_t instante_ns, string_view contenido)
+{
+    if (grabador.fd < 0)
+        return;
+
+    CabeceraRegistro cabecera{};
+    cabecera.instante_ns = instante_ns;
+    cabecera.longitud = static_cast<uint32_t>(contenido.size());
+    cabecera.sentido = sentido;
+
+    const char *bytes = reinterpret_cast<const char *>(&cabecera);
+    grabador.pendiente.insert(grabador.pendiente.end(), bytes, bytes + sizeof(cabecera));
+    grabador.pendiente.insert(grabador.pendiente.end(), contenido.begin(), contenido.end());
+    grabador.pendiente.resize(alinear(grabador.pendiente.size()), '\0');
+
+    if (grabador.pendiente.size() >= TAM_BLOQUE_ESCRITURA)
+        volcar(grabador);
+}
+
+/**
+ * @brief Vuelca lo pendiente y cierra el fichero
+ *
+ * @param grabador Grabador a cerrar
+ */
+void cerrar_grabador(Grabador &grabador)
+{
+    if (grabador.fd < 0)
+        return;
+    volcar(grabador);
+    close(grabador.fd);
+    grabador.fd = -1;
+}
+
+/**
+ * @brief Abre y proyecta con mmap un fichero de registro
+ *
+ * @param lector Lector a inicializar
+ * @param ruta Ruta del fichero
+ * @return true si el fichero existe y tiene una cabecera válida
+ */
+bool abrir_lector(LectorRegistro &lector, string const &ruta)
+{
+    lector.fd = open(ruta.c_str(), O_RDONLY | O_CLOEXEC);
+    if (lector.fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(lector.fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(MAGICO))
+    {
+        cerrar_lector(lector);
+        return false;
+    }
+    lector.tam = static_cast<size_t>(info.st_size);
+
+    void *proyeccion = mmap(nullptr, lector.tam, PROT_READ, MAP_PRIVATE, lector.fd, 0);
+    if (proyeccion == MAP_FAILED)
+    {
+        cerrar_lector(lector);
+        return false;
+    }
+    lector.datos = static_cast<const char *>(proyeccion);
+    madvise(proyeccion, lector.tam, MADV_SEQUENTIAL);
+
+    if (memcmp(lector.datos, MAGICO, sizeof(MAGICO)) != 0)
+    {
+        cerrar_lector(lector);
+        return false;
+    }
+    lector.posicion = sizeof(MAGICO);
+    return true;
+}
+
+/**
+ * @brief Devuelve el siguiente registro sin copiar su contenido
+ *
+ * @param lector Lector abierto
+ * @param registro Registro de salida
+ * @return false al llegar al final del fichero o ante un registro truncado
+ */
+bool siguiente_registro(LectorRegistro &lector, Registro &registro)
+{
+    if (lector.posicion + sizeof(CabeceraRegistro) > lector.tam)
+        return false;
+
+    // Las cabeceras están alineadas a 8 bytes dentro de la proyección
+    auto const *cabecera = reinterpret_cast<CabeceraRegistro const *>(lector.datos + lector.posicion);
+    size_t inicio = lector.posicion + sizeof(CabeceraRegistro);
+    if (inicio + cabecera->longitud > lector.tam)
+        return false;
+
+    registro.instante_ns = cabecera->instante_ns;
+    registro.sentido = cabecera->sentido;
+    registro.contenido = string_view(lector.datos + inicio, cabecera->longitud);
+    lector.posicion = alinear(inicio + cabecera->longitud);
+    return true;
+}
+
+/**
+ * @brief Vuelve al primer registro del fichero
+ *
+ * @param lector Lector abierto
+ */
+void rebobinar_lector(LectorRegistro &lector)
+{
+    lector.posicion = sizeof(MAGICO);
+}
+
+/**
+ * @brief Libera la proyección y cierra el fichero
+ *
+ * @param lector Lector a cerrar
+ */
+void cerrar_lector(LectorRegistro &lector)
+{
+    if (lector.datos != nullptr)
+        munmap(const_cast<char *>(lector.datos), lector.tam);
+    if (lector.fd >= 0)
+        close(lector.fd);
+    lector.datos = nullptr;
+    lector.fd = -1;
+    lector.tam = 0;
+    lector.posicion = 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file registro.h
+ * @brief Archivo de cabecera del registro binario de tráfico con el servidor
+ *
+ * Graba cada datagrama recibido y cada comando enviado por un jugador, con su
+ * marca de tiempo en nanosegundos, en un fichero binario de solo anexado.
+ * La lectura proyecta el fichero con mmap y recorre los registros sin copiar
+ * su contenido, de modo que un partido completo se puede reproducir offline
+ * a través de la cadena de percepción y decisión sin sockets.
+ *
+ * Formato: cabecera de 8 bytes ("RCSSLOG1") seguida de registros
+ * [CabeceraRegistro][contenido][relleno hasta múltiplo de 8].
+ */
+
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+// Inclusión de dependencias
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+/// Sentido de un registro
+enum class Sentido : uint8_t
+{
+    Recibido = 0,   ///< Datagrama recibido del servidor
+    Enviado = 1     ///< Comando enviado al servidor
+};
+
+/**
+ * @brief Cabecera fija de cada registro en el fichero
+ */
+struct CabeceraRegistro
+{
+    int64_t instante_ns;   ///< Marca de tiempo (CLOCK_REALTIME)
+    uint32_t longitud;     ///< Bytes de contenido que siguen a la cabecera
+    Sentido sentido;       ///< Recibido o enviado
+    uint8_t reservado[3];  ///< Relleno (a cero)
+};
+
+/**
+ * @brief Registro leído: la vista apunta directamente al fichero proyectado
+ */
+struct Registro
+{
+    int64_t instante_ns;
+    Sentido sentido;
+    string_view contenido;
+};
+
+/**
+ * @brief Escritor de registros con buffer propio (una escritura por bloque)
+ */
+struct Grabador
+{
+    int fd;                  ///< Fichero de salida (-1 si la grabación está desactivada)
+    vector<char> pendiente;  ///< Bytes aún no escritos en disco
+
+    /**
+     * @brief Constructor por defecto (grabación desactivada)
+     */
+    Grabador()
+        : fd(-1), pendiente() {}
+};
+
+/**
+ * @brief Lector de un fichero de registro proyectado en memoria
+ */
+struct LectorRegistro
+{
+    int fd;               ///< Fichero abierto
+    const char *datos;    ///< Inicio de la proyección
+    size_t tam;           ///< Tamaño del fichero
+    size_t posicion;      ///< Desplazamiento del siguiente registro
+
+    /**
+     * @brief Constructor por defecto
+     */
+    LectorRegistro()
+        : fd(-1), datos(nullptr), tam(0), posicion(0) {}
+};
+
+/**
+ * @brief Crea (o trunca) un fichero de registro y escribe su cabecera
+ *
+ * @param grabador Grabador a inicializar
+ * @param ruta Ruta del fichero
+ * @return true si el fichero se ha creado
+ */
+bool abrir_grabador(Grabador &grabador, string const &ruta);
+
+/**
+ * @brief Añade un registro al fichero
+ *
+ * @param grabador Grabador activo (si está desactivado no hace nada)
+ * @param sentido Recibido o enviado
+ * @param instante_ns Marca de tiempo del mensaje
+ * @param contenido Bytes del mensaje
+ */
+void grabar(Grabador &grabador, Sentido sentido, int64_t instante_ns, string_view contenido);
+
+/**
+ * @brief Vuelca lo pendiente y cierra el fichero
+ *
+ * @param grabador Grabador a cerrar
+ */
+void cerrar_grabador(Grabador &grabador);
+
+/**
+ * @brief Abre y proyecta con mmap un fichero de registro
+ *
+ * @param lector Lector a inicializar
+ * @param ruta Ruta del fichero
+ * @return true si el fichero existe y tiene una cabecera válida
+ */
+bool abrir_lector(LectorRegistro &lector, string const &ruta);
+
+/**
+ * @brief Devuelve el siguiente registro sin copiar su contenido
+ *
+ * @param lector Lector abierto
+ * @param registro Registro de salida (su contenido apunta a la proyección)
+ * @return false al llegar al final del fichero o ante un registro truncado
+ */
+bool siguiente_registro(LectorRegistro &lector, Registro &registro);
+
+/**
+ * @brief Vuelve al primer registro del fichero
+ *
+ * @param lector Lector abierto
+ */
+void rebobinar_lector(LectorRegistro &lector);
+
+/**
+ * @brief Libera la proyección y cierra el fichero
+ *
+ * @param lector Lector a cerrar
+ */
+void cerrar_lector(LectorRegistro &lector);
+
+#endif // REGISTRO_H
@@ -0,0 +1,102 @@
+/**
+ * @file replay.cpp
+ * @brief Reproducción offline de un registro binario de un jugador
+ *
+ * Recorre con mmap un fichero grabado con RCSS_REGISTRO y pasa cada mensaje
+ * recibido por la misma cadena que el agente en directo (send_message_funtion,
+ * crear_matriz_valores_absolutos, relative2Abssolute y sendMessage), sin
+ * sockets ni esperas. Sirve para perfilar y comparar versiones del
+ * pipeline de decisión sobre partidos reales.
+ *
+ * Uso: ./replay_agent <fichero.rlog> [--comandos]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "agente.h"
+#include "AbsPos.h"
+#include "Funciones.h"
+#include "registro.h"
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2 && argc != 3)
+    {
+        cout << "Uso: " << argv[0] << " <fichero.rlog> [--comandos]" << endl;
+        return 1;
+    }
+    bool mostrar_comandos = (argc == 3 && string(argv[2]) == "--comandos");
+
+    LectorRegistro lector;
+    if (!abrir_lector(lector, argv[1]))
+    {
+        cout << "No se puede abrir el registro " << argv[1] << endl;
+        return 1;
+    }
+
+    // Misma semilla en cada reproducción para poder comparar versiones
+    srand(0);
+
+    Agente agente;
+    inicializacion_flags(agente.flags);
+
+    uint64_t recibidos{0}, enviados{0}, ciclos{0};
+    auto inicio = chrono::steady_clock::now();
+
+    Registro registro;
+    while (siguiente_registro(lector, registro))
+    {
+        string_view contenido = registro.contenido;
+
+        // Los comandos grabados solo aportan el nombre del equipo (del init)
+        if (registro.sentido == Sentido::Enviado)
+        {
+            enviados++;
+            if (contenido.starts_with("(init "))
+            {
+                size_t fin = contenido.find_first_of(" )", 6);
+                agente.datos.nombre_equipo = string(contenido.substr(6, fin - 6));
+            }
+            continue;
+        }
+        recibidos++;
+
+        // Respuesta al init: sin socket, solo se rellena el estado
+        if (!agente.inicializado)
+        {
+            try
+            {
+                procesar_init(contenido, agente.datos, agente.comando_pendiente);
+            }
+            catch (const std::exception &e)
+            {
+                cout << e.what() << endl;
+            }
+            agente.inicializado = true;
+            continue;
+        }
+
+        if (percibir(agente, contenido))
+        {
+            sendMessage(agente.datos, agente.comando_pendiente);
+            // Como si se hubiera enviado: el modelo del mundo sigue igual que en el agente
+            aplicar_comando_enviado(agente.comando_pendiente, agente.datos);
+            ciclos++;
+            if (mostrar_comandos)
+                cout << registro.instante_ns << " " << agente.comando_pendiente.texto() << endl;
+        }
+    }
+
+    auto duracion = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    cerrar_lector(lector);
+
+    cout << "Registros recibidos: " << recibidos << ", enviados: " << enviados << endl;
+    cout << "Ciclos de decisión: " << ciclos << endl;
+    cout << "Tiempo total: " << duracion * 1e3 << " ms";
+    if (ciclos > 0)
+        cout << " (" << duracion * 1e6 / ciclos << " us por ciclo)";
+    cout << endl;
+    return 0;
+}
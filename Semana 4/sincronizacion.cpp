@@ -0,0 +1,107 @@
+/**
+ * @file sincronizacion.cpp
+ * @brief Implementación del estimador de fase del ciclo del servidor
+ */
+
+#include "sincronizacion.h"
+
+#include <ctime>
+
+/**
+ * @brief Instante actual en nanosegundos (CLOCK_REALTIME)
+ */
+int64_t ahora_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Inicio del ciclo que contiene al instante dado, según la fase estimada
+ */
+static int64_t inicio_ciclo_en(RelojCiclo const &reloj, int64_t instante)
+{
+    int64_t transcurrido = instante - reloj.inicio_ciclo_ns;
+    int64_t ciclos = transcurrido / PERIODO_CICLO_NS;
+    if (transcurrido < 0 && transcurrido % PERIODO_CICLO_NS != 0)
+        ciclos--;
+    return reloj.inicio_ciclo_ns + ciclos * PERIODO_CICLO_NS;
+}
+
+/**
+ * @brief Registra la llegada de un sense_body y actualiza la fase estimada
+ *
+ * @param reloj Estado del estimador
+ * @param llegada_ns Marca de tiempo de llegada del datagrama
+ * @param ciclo Tiempo de simulación indicado en el sense_body
+ */
+void registrar_inicio_ciclo(RelojCiclo &reloj, int64_t llegada_ns, int ciclo)
+{
+    // ======================================================
+    // CONTADORES DE CICLO
+    // ======================================================
+    if (ciclo != reloj.ultimo_ciclo)
+    {
+        if (reloj.ciclos > 0 && !reloj.comando_en_ciclo)
+            reloj.ciclos_sin_comando++;
+        reloj.ciclos++;
+        reloj.comando_en_ciclo = false;
+        reloj.ultimo_ciclo = ciclo;
+    }
+
+    // ======================================================
+    // ACTUALIZACIÓN DE LA FASE
+    // ======================================================
+    if (!reloj.fase_valida)
+    {
+        reloj.inicio_ciclo_ns = llegada_ns;
+        reloj.fase_valida = true;
+        return;
+    }
+
+    // Desfase respecto al inicio de ciclo previsto más cercano, en [-P/2, P/2)
+    int64_t desfase = llegada_ns - inicio_ciclo_en(reloj, llegada_ns);
+    if (desfase >= PERIODO_CICLO_NS / 2)
+        desfase -= PERIODO_CICLO_NS;
+
+    if (desfase < 0)
+        reloj.inicio_ciclo_ns += desfase;      // llegada más temprana: el retardo mínimo manda
+    else
+        reloj.inicio_ciclo_ns += desfase / 8;  // deriva lenta ante retrasos sostenidos
+
+    reloj.inicio_ciclo_ns = inicio_ciclo_en(reloj, llegada_ns);
+}
+
+/**
+ * @brief Calcula el último instante seguro para enviar el comando del ciclo en curso
+ *
+ * @param reloj Estado del estimador
+ * @param ahora Instante actual
+ * @return Plazo de envío (nunca anterior a ahora)
+ */
+int64_t plazo_envio(RelojCiclo const &reloj, int64_t ahora)
+{
+    if (!reloj.fase_valida)
+        return ahora;
+
+    int64_t plazo = inicio_ciclo_en(reloj, ahora) + PERIODO_CICLO_NS - reloj.margen_ns;
+    return (plazo > ahora) ? plazo : ahora;
+}
+
+/**
+ * @brief Registra el envío de un comando para los contadores de puntualidad
+ *
+ * @param reloj Estado del estimador
+ * @param plazo Plazo con el que se programó el comando
+ * @param instante Instante real del envío
+ */
+void registrar_envio(RelojCiclo &reloj, int64_t plazo, int64_t instante)
+{
+    reloj.comandos_enviados++;
+    reloj.comando_en_ciclo = true;
+
+    // Enviar después del final del ciclo al que pertenece el plazo pierde el paso
+    if (reloj.fase_valida && instante >= inicio_ciclo_en(reloj, plazo) + PERIODO_CICLO_NS)
+        reloj.comandos_tardios++;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file sincronizacion.h
+ * @brief Archivo de cabecera del estimador de fase del ciclo del servidor
+ *
+ * El servidor RCSS avanza la simulación cada 100 ms y envía el sense_body
+ * al comienzo de cada ciclo. A partir de las marcas de tiempo de llegada de
+ * esos mensajes se estima la fase del ciclo, lo que permite retrasar el envío
+ * de cada comando hasta el último instante seguro antes del siguiente paso.
+ */
+
+#ifndef SINCRONIZACION_H
+#define SINCRONIZACION_H
+
+// Inclusión de dependencias
+#include <cstdint>
+
+using namespace std;
+
+/// Duración de un ciclo de simulación del servidor (simulator_step = 100 ms)
+constexpr int64_t PERIODO_CICLO_NS = 100'000'000;
+
+/// Margen de seguridad por defecto antes del final del ciclo
+constexpr int64_t MARGEN_ENVIO_NS = 10'000'000;
+
+/**
+ * @brief Estado del estimador de fase y contadores de puntualidad
+ */
+struct RelojCiclo
+{
+    int64_t inicio_ciclo_ns;      ///< Inicio estimado del último ciclo observado (CLOCK_REALTIME)
+    bool fase_valida;             ///< Se ha recibido al menos un sense_body
+    int64_t margen_ns;            ///< Antelación con la que se envía el comando antes del fin de ciclo
+    int ultimo_ciclo;             ///< Tiempo de simulación del último sense_body
+    bool comando_en_ciclo;        ///< Se ha enviado algún comando durante el ciclo actual
+    uint64_t ciclos;              ///< Ciclos observados
+    uint64_t ciclos_sin_comando;  ///< Ciclos completos en los que no se envió ningún comando
+    uint64_t comandos_enviados;   ///< Comandos despachados
+    uint64_t comandos_tardios;    ///< Comandos enviados después del final del ciclo previsto
+
+    /**
+     * @brief Constructor por defecto
+     */
+    RelojCiclo()
+        : inicio_ciclo_ns(0), fase_valida(false), margen_ns(MARGEN_ENVIO_NS),
+        ultimo_ciclo(-1), comando_en_ciclo(false), ciclos(0),
+        ciclos_sin_comando(0), comandos_enviados(0), comandos_tardios(0) {}
+};
+
+/**
+ * @brief Instante actual en nanosegundos (CLOCK_REALTIME, la misma base que SO_TIMESTAMPNS)
+ */
+int64_t ahora_ns();
+
+/**
+ * @brief Registra la llegada de un sense_body y actualiza la fase estimada
+ *
+ * Las llegadas solo pueden retrasarse respecto al inicio real del ciclo, así
+ * que el estimador adopta de inmediato cualquier llegada más temprana de lo
+ * previsto y solo se desplaza lentamente ante retrasos sostenidos.
+ *
+ * @param reloj Estado del estimador
+ * @param llegada_ns Marca de tiempo de llegada del datagrama
+ * @param ciclo Tiempo de simulación indicado en el sense_body
+ */
+void registrar_inicio_ciclo(RelojCiclo &reloj, int64_t llegada_ns, int ciclo);
+
+/**
+ * @brief Calcula el último instante seguro para enviar el comando del ciclo en curso
+ *
+ * @param reloj Estado del estimador
+ * @param ahora Instante actual
+ * @return Plazo de envío; igual a ahora si la fase aún no es válida o si el
+ *         plazo del ciclo actual ya ha pasado (envío inmediato)
+ */
+int64_t plazo_envio(RelojCiclo const &reloj, int64_t ahora);
+
+/**
+ * @brief Registra el envío de un comando para los contadores de puntualidad
+ *
+ * @param reloj Estado del estimador
+ * @param plazo Plazo con el que se programó el comando
+ * @param instante Instante real del envío
+ */
+void registrar_envio(RelojCiclo &reloj, int64_t plazo, int64_t instante);
+
+#endif // SINCRONIZACION_H
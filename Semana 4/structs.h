@@ -12,7 +12,10 @@
 #define STRUCTS_H
 
 // Inclusión de dependencias
+#include <array>     // Para almacenes de capacidad fija
+#include <cstdint>   // Para enteros de tamaño fijo
 #include <string>    // Para cadenas de texto
+#include <string_view> // Para nombres de flags constantes
 #include <vector>    // Para contenedores dinámicos
 
 using namespace std;
@@ -25,13 +28,87 @@ using namespace std;
  */
 struct knownFlags
 {
-    string name;        ///< Nombre identificativo del flag (ej: "f c t")
+    string_view name;   ///< Nombre identificativo del flag (ej: "(f c t)"), texto estático
     int x;              ///< Coordenada X absoluta en el campo
     int y;              ///< Coordenada Y absoluta en el campo
     float distancia;    ///< Distancia relativa desde el jugador al flag (metros)
     float direccion;    ///< Ángulo relativo desde el jugador al flag (grados)
 };
 
+/// Valor sentinela para distancias y ángulos desconocidos
+constexpr float DESCONOCIDO = 999.0f;
+
+/**
+ * @brief Lado del campo en el que juega un equipo
+ */
+enum class Lado : uint8_t
+{
+    Desconocido,   ///< Aún no se ha recibido el init
+    Izquierdo,     ///< "l": ataca hacia la derecha
+    Derecho        ///< "r": ataca hacia la izquierda
+};
+
+/**
+ * @brief Modo de juego anunciado por el árbitro ("hear ... referee")
+ *
+ * El lado al que se refiere ("_l" / "_r") se guarda aparte en EventoArbitro.
+ */
+enum class ModoJuego : uint8_t
+{
+    Desconocido,        ///< Sin anunciar aún, o mensaje no reconocido
+    BeforeKickOff,      ///< before_kick_off
+    PlayOn,             ///< play_on
+    TimeOver,           ///< time_over
+    KickOff,            ///< kick_off_l / kick_off_r
+    KickIn,             ///< kick_in_l / kick_in_r
+    FreeKick,           ///< free_kick_l / free_kick_r
+    IndirectFreeKick,   ///< indirect_free_kick_l / indirect_free_kick_r
+    CornerKick,         ///< corner_kick_l / corner_kick_r
+    GoalKick,           ///< goal_kick_l / goal_kick_r
+    Goal,               ///< goal_l_N / goal_r_N
+    DropBall,           ///< drop_ball
+    Offside,            ///< offside_l / offside_r
+    PenaltyKick,        ///< penalty_kick_l / penalty_kick_r
+    FoulCharge,         ///< foul_charge_l / foul_charge_r
+    FoulPush,           ///< foul_push_l / foul_push_r
+    BackPass,           ///< back_pass_l / back_pass_r
+    FreeKickFault,      ///< free_kick_fault_l / free_kick_fault_r
+    CatchFault,         ///< catch_fault_l / catch_fault_r
+    GoalieCatchBall,    ///< goalie_catch_ball_l / goalie_catch_ball_r
+    YellowCard,         ///< yellow_card_l_N / yellow_card_r_N
+    RedCard,            ///< red_card_l_N / red_card_r_N
+    HalfTime,           ///< half_time
+    ExtraHalfTime,      ///< extra_half_time
+    TimeExtended,       ///< time_extended
+    TimeUp,             ///< time_up
+    NumModos
+};
+
+/**
+ * @brief Último evento del árbitro ya decodificado: modo de juego y lado
+ */
+struct EventoArbitro
+{
+    ModoJuego modo;     ///< Modo de juego
+    Lado lado;          ///< Equipo al que se refiere (Desconocido si no lleva lado)
+
+    /**
+     * @brief Constructor por defecto (ningún evento recibido)
+     */
+    EventoArbitro()
+        : modo(ModoJuego::Desconocido), lado(Lado::Desconocido) {}
+
+    EventoArbitro(ModoJuego m, Lado l)
+        : modo(m), lado(l) {}
+
+    bool operator==(EventoArbitro const &) const = default;
+
+    /**
+     * @brief Indica si el evento es el modo dado para el lado dado
+     */
+    bool es(ModoJuego m, Lado l) const { return modo == m && lado == l; }
+};
+
 /**
  * @brief Estructura que representa al jugador controlado por este agente
  *
@@ -40,11 +117,16 @@ struct knownFlags
  */
 struct Player
 {
-    string jugador_numero;   ///< Número identificativo del jugador (1-11)
-    string lado_campo;       ///< Lado del campo: "l" (izquierda) o "r" (derecha)
+    int jugador_numero;      ///< Número identificativo del jugador (1-11, 0 si aún no se conoce)
+    Lado lado_campo;         ///< Lado del campo del equipo
     string nombre_equipo;    ///< Nombre del equipo al que pertenece
     float x_absoluta;        ///< Coordenada X absoluta en el campo (si se conoce)
     float y_absoluta;        ///< Coordenada Y absoluta en el campo (si se conoce)
+    float orientacion_cuerpo;   ///< Dirección global del cuerpo en grados (0 = +X, antihorario)
+    float orientacion_cuello;   ///< Dirección global del cuello, es decir de la vista (mismo convenio)
+    float angulo_cuello;        ///< Ángulo del cuello respecto al cuerpo en grados (head_angle: horario, ±90)
+    float error_orientacion;    ///< Desviación típica estimada de la orientación en grados
+    float confianza_posicion;   ///< Confianza de la posición y orientación (0 = desconocida, 1 = exacta)
     bool tengo_balon;        ///< Indica si el jugador tiene posesión del balón
     bool equipo_tiene_balon; ///< Indica si algún compañero tiene posesión del balón
     bool saque_puerta;       ///< Indica si el jugador debe realizar saque de puerta
@@ -53,48 +135,183 @@ struct Player
      * @brief Constructor por defecto que inicializa todos los miembros con valores seguros
      *
      * Valores iniciales:
-     * - Coordenadas: 999.0 (valor sentinela indicando "desconocido")
+     * - Coordenadas y orientación: 999.0 (valor sentinela indicando "desconocido"), confianza 0
      * - Banderas booleanas: false (estado inicial seguro)
-     * - Cadenas: vacías
+     * - Número y lado: desconocidos
      */
     Player()
-        : jugador_numero(""), lado_campo(""), nombre_equipo(""),
-        x_absoluta(999.0f), y_absoluta(999.0f), tengo_balon(false),
+        : jugador_numero(0), lado_campo(Lado::Desconocido), nombre_equipo(""),
+        x_absoluta(999.0f), y_absoluta(999.0f), orientacion_cuerpo(999.0f),
+        orientacion_cuello(999.0f), angulo_cuello(0.0f), error_orientacion(999.0f),
+        confianza_posicion(0.0f), tengo_balon(false),
         equipo_tiene_balon(false), saque_puerta(false) {}
 };
 
+/// Capacidad del almacén de jugadores vistos (los 22 del partido)
+constexpr int MAX_JUGADORES_VISTOS = 22;
+
 /**
  * @brief Estructura que almacena información sobre jugadores visibles en el campo
  *
- * Clasifica y organiza la información de compañeros y rivales detectados
- * mediante mensajes de percepción ("see").
+ * Almacén de capacidad fija en forma de estructura de arrays: cada campo de
+ * los jugadores vistos en el último "see" (compañeros y rivales, en el orden
+ * del mensaje) está en su propio array, de modo que recorrer solo distancias
+ * o solo compañeros lee memoria contigua. Se rellena en su sitio en cada
+ * ciclo y nunca reserva memoria. Tras la localización, proyectar_observaciones
+ * añade la posición cartesiana de cada jugador (x, y).
  */
 struct Jugadores_Vistos
 {
-    vector<vector<string>> jugadores;           ///< Matriz de compañeros detectados [distancia, ángulo, número]
-    bool veo_equipo;                            ///< Indica si se detectaron compañeros
-    vector<vector<string>> jugadores_contrario; ///< Matriz de rivales detectados [distancia, ángulo, número]
-    bool veo_equipo_contrario;                  ///< Indica si se detectaron rivales
+    int num;                                            ///< Jugadores válidos (primeros num huecos)
+    int num_companeros;                                 ///< Cuántos de ellos son compañeros
+    array<float, MAX_JUGADORES_VISTOS> distancia;       ///< Distancia en metros
+    array<float, MAX_JUGADORES_VISTOS> direccion;       ///< Ángulo relativo en grados
+    array<uint8_t, MAX_JUGADORES_VISTOS> numero;        ///< Dorsal (1-11; 0 si está demasiado lejos)
+    array<bool, MAX_JUGADORES_VISTOS> companero;        ///< true si es de nuestro equipo
+    array<bool, MAX_JUGADORES_VISTOS> portero;          ///< true si lleva la marca goalie
+    array<float, MAX_JUGADORES_VISTOS> x;               ///< Posición proyectada (ver en_campo)
+    array<float, MAX_JUGADORES_VISTOS> y;
+    bool en_campo;                                      ///< x, y son del campo; si no, relativas a la vista propia
+    bool veo_equipo;                                    ///< Indica si se detectaron compañeros
+    bool veo_equipo_contrario;                          ///< Indica si se detectaron rivales
 
     /**
      * @brief Constructor por defecto
      */
     Jugadores_Vistos()
-        : jugadores(), veo_equipo(false),
-        jugadores_contrario(), veo_equipo_contrario(false) {}
+        : num(0), num_companeros(0), distancia(), direccion(), numero(), companero(), portero(),
+        x(), y(), en_campo(false), veo_equipo(false), veo_equipo_contrario(false) {}
+
+    /**
+     * @brief Vacía el almacén (no toca los indicadores veo_*)
+     */
+    void limpiar()
+    {
+        num = 0;
+        num_companeros = 0;
+    }
+
+    /**
+     * @brief Añade un jugador al final del almacén
+     *
+     * @return false si el almacén está lleno
+     */
+    bool anadir(int dorsal, float dist, float dir, bool es_companero, bool es_portero)
+    {
+        if (num == MAX_JUGADORES_VISTOS)
+            return false;
+        distancia[num] = dist;
+        direccion[num] = dir;
+        numero[num] = static_cast<uint8_t>(dorsal);
+        companero[num] = es_companero;
+        portero[num] = es_portero;
+        num_companeros += es_companero;
+        num++;
+        return true;
+    }
+};
+
+/// Jugadores por equipo y en el partido
+constexpr int JUGADORES_POR_EQUIPO = 11;
+constexpr int NUM_JUGADORES_PARTIDO = 2 * JUGADORES_POR_EQUIPO;
+
+/**
+ * @brief Modelo persistente de los 22 jugadores del partido
+ *
+ * Un hueco por jugador (0-10 compañeros con dorsal 1-11, 11-21 rivales) en
+ * forma de estructura de arrays. Cada "see" solo escribe los huecos de los
+ * jugadores que aparecen; el resto conserva su última estimación, cuya
+ * confianza baja con el tiempo transcurrido (ver mundo.h). El balón
+ * persistente es Ball::filtro.
+ */
+struct MundoJugadores
+{
+    int tiempo;                                     ///< Ciclo del último "see" incorporado
+    array<int, NUM_JUGADORES_PARTIDO> ultima_vista; ///< Ciclo de la última observación (-1 si nunca)
+    array<float, NUM_JUGADORES_PARTIDO> x;          ///< Posición estimada en el campo en ultima_vista
+    array<float, NUM_JUGADORES_PARTIDO> y;
+    array<float, NUM_JUGADORES_PARTIDO> vx;         ///< Desplazamiento estimado por ciclo
+    array<float, NUM_JUGADORES_PARTIDO> vy;
+    array<float, NUM_JUGADORES_PARTIDO> error;      ///< Desviación típica (m) de la posición en ultima_vista
+
+    /**
+     * @brief Constructor por defecto (ningún jugador visto)
+     */
+    MundoJugadores()
+        : tiempo(-1), ultima_vista(), x(), y(), vx(), vy(), error()
+    {
+        ultima_vista.fill(-1);
+    }
+};
+
+/**
+ * @brief Punto del campo en coordenadas absolutas
+ */
+struct Punto
+{
+    float x;
+    float y;
+};
+
+/**
+ * @brief Odometría propia a partir de sense_body y de los comandos enviados
+ *
+ * Entre localizaciones la pose del jugador avanza con la velocidad que
+ * informa sense_body y gira con los turn enviados; la aceleración de los dash
+ * se guarda hasta el siguiente ciclo por si falta algún sense_body.
+ */
+struct Odometria
+{
+    int tiempo;                 ///< Ciclo del último sense_body (-1 si no ha llegado ninguno)
+    float stamina;              ///< Resistencia disponible
+    float esfuerzo;             ///< Fracción de la potencia del dash que se aprovecha (effort)
+    float vx;                   ///< Velocidad propia en el campo (m/ciclo), tras el decaimiento
+    float vy;
+    float ax;                   ///< Aceleración de los dash enviados y aún no aplicados
+    float ay;
+
+    /**
+     * @brief Constructor por defecto (sin sense_body)
+     */
+    Odometria()
+        : tiempo(-1), stamina(0.0f), esfuerzo(1.0f), vx(0.0f), vy(0.0f), ax(0.0f), ay(0.0f) {}
+};
+
+/**
+ * @brief Filtro de Kalman de velocidad constante del balón, en coordenadas del campo
+ *
+ * Estado (x, y, vx, vy) en metros y metros/ciclo, con su covarianza. Entre
+ * observaciones se predice con el decaimiento de velocidad del servidor.
+ */
+struct FiltroBalon
+{
+    bool inicializado;                      ///< Se ha visto el balón con la pose conocida
+    int tiempo;                             ///< Ciclo al que corresponde el estado
+    int ultima_vista;                       ///< Ciclo de la última observación aceptada
+    array<float, 4> estado;                 ///< x, y, vx, vy
+    array<array<float, 4>, 4> covarianza;   ///< Covarianza del estado
+
+    /**
+     * @brief Constructor por defecto (sin estimación)
+     */
+    FiltroBalon()
+        : inicializado(false), tiempo(-1), ultima_vista(-1), estado(), covarianza() {}
 };
 
 /**
  * @brief Estructura que representa el estado del balón respecto al jugador
  *
  * Almacena información de percepción sobre el balón: distancia, dirección
- * relativa y estado de visibilidad.
+ * relativa y estado de visibilidad, y la estimación filtrada en el campo.
  */
 struct Ball
 {
-    string balon_distancia;  ///< Distancia al balón en metros (como string)
-    string balon_direccion;  ///< Ángulo relativo al balón en grados (como string)
+    float balon_distancia;   ///< Distancia al balón en metros
+    float balon_direccion;   ///< Ángulo relativo al balón en grados
     bool veo_balon;          ///< Indica si el balón está actualmente visible
+    float balon_x;           ///< Posición proyectada, en el mismo marco que los jugadores vistos
+    float balon_y;
+    FiltroBalon filtro;      ///< Posición y velocidad estimadas (también sin verlo)
 
     /**
      * @brief Constructor por defecto con valores iniciales seguros
@@ -103,7 +320,8 @@ struct Ball
      * y veo_balon en false.
      */
     Ball()
-        : balon_distancia("999.0"), balon_direccion("999.0"), veo_balon(false) {}
+        : balon_distancia(DESCONOCIDO), balon_direccion(DESCONOCIDO), veo_balon(false),
+        balon_x(DESCONOCIDO), balon_y(DESCONOCIDO), filtro() {}
 };
 
 /**
@@ -114,12 +332,12 @@ struct Ball
  */
 struct Goal
 {
-    string palo_abajo_distancia;     ///< Distancia al palo inferior de la portería
-    string palo_abajo_direccion;     ///< Ángulo al palo inferior de la portería
-    string palo_arriba_distancia;    ///< Distancia al palo superior de la portería
-    string palo_arriba_direccion;    ///< Ángulo al palo superior de la portería
-    string centro_distancia;         ///< Distancia al centro de la portería
-    string centro_direccion;         ///< Ángulo al centro de la portería
+    float palo_abajo_distancia;      ///< Distancia al palo inferior de la portería
+    float palo_abajo_direccion;      ///< Ángulo al palo inferior de la portería
+    float palo_arriba_distancia;     ///< Distancia al palo superior de la portería
+    float palo_arriba_direccion;     ///< Ángulo al palo superior de la portería
+    float centro_distancia;          ///< Distancia al centro de la portería
+    float centro_direccion;          ///< Ángulo al centro de la portería
     bool veo_porteria_contraria;     ///< Indica si la portería contraria es visible
     bool veo_porteria_propia;        ///< Indica si la portería propia es visible
 
@@ -127,9 +345,9 @@ struct Goal
      * @brief Constructor por defecto con valores iniciales seguros
      */
     Goal()
-        : palo_abajo_distancia("999.0"), palo_abajo_direccion("999.0"),
-        palo_arriba_distancia("999.0"), palo_arriba_direccion("999.0"),
-        centro_distancia("999.0"), centro_direccion("999.0"),
+        : palo_abajo_distancia(DESCONOCIDO), palo_abajo_direccion(DESCONOCIDO),
+        palo_arriba_distancia(DESCONOCIDO), palo_arriba_direccion(DESCONOCIDO),
+        centro_distancia(DESCONOCIDO), centro_direccion(DESCONOCIDO),
         veo_porteria_contraria(false), veo_porteria_propia(false) {}
 };
 
@@ -142,17 +360,37 @@ struct Goal
 struct jugadorCercaPase
 {
     bool hayJugador;        ///< Indica si existe un compañero bien posicionado
-    string direccion;        ///< Ángulo hacia el compañero (grados como string)
-    string distancia;        ///< Distancia al compañero (metros como string)
-    string numero_jugador;   ///< Número identificativo del compañero
+    float direccion;        ///< Ángulo hacia el compañero (grados)
+    float distancia;        ///< Distancia al compañero (metros)
+    int numero_jugador;     ///< Número identificativo del compañero
 
     /**
      * @brief Constructor por defecto
      */
     jugadorCercaPase()
-        : hayJugador(false), direccion("999.0"),
-        distancia("999.0"), numero_jugador("") {}
+        : hayJugador(false), direccion(DESCONOCIDO),
+        distancia(DESCONOCIDO), numero_jugador(0) {}
+};
+
+#ifdef RCSS_CONTAR_COPIAS
+/// Bytes de estructuras copiadas (solo en bench_agent, que compila con RCSS_CONTAR_COPIAS)
+inline uint64_t bytes_copiados = 0;
+
+/**
+ * @brief Miembro vacío que suma sizeof(T) a bytes_copiados en cada copia de T
+ */
+template <typename T>
+struct ContadorCopias
+{
+    ContadorCopias() = default;
+    ContadorCopias(ContadorCopias const &) { bytes_copiados += sizeof(T); }
+    ContadorCopias &operator=(ContadorCopias const &)
+    {
+        bytes_copiados += sizeof(T);
+        return *this;
+    }
 };
+#endif
 
 /**
  * @brief Estructura principal que agrega todo el estado del juego
@@ -164,23 +402,28 @@ struct Game_data
 {
     string nombre_equipo;            ///< Nombre del equipo controlado
     Player jugador;                  ///< Información específica del jugador
+    Odometria odometria;             ///< Velocidad y resistencia propias (sense_body)
     Ball ball;                       ///< Estado del balón
     Goal porteria;                   ///< Información de porterías
     Jugadores_Vistos jugadores_vistos; ///< Jugadores visibles
+    MundoJugadores mundo;            ///< Los 22 jugadores, también fuera de la vista
     jugadorCercaPase jugadorCerca;   ///< Posible receptor de pase
-    string evento;                   ///< Evento actual del juego (kick_off, goal, etc.)
-    string evento_anterior;          ///< Evento previo (para detección de cambios)
-    string lado_campo;               ///< Lado del campo ("l" o "r")
+    EventoArbitro evento;            ///< Evento actual del juego (kick_off, goal, etc.)
+    EventoArbitro evento_anterior;   ///< Evento previo (para detección de cambios)
+    Lado lado_campo;                 ///< Lado del campo
     bool flag_kick_off;              ///< Indica si es el inicio del partido o tras gol
+#ifdef RCSS_CONTAR_COPIAS
+    [[no_unique_address]] ContadorCopias<Game_data> copias; ///< Cuenta las copias en el benchmark
+#endif
 
     /**
      * @brief Constructor por defecto que inicializa todos los componentes
      */
     Game_data()
-        : nombre_equipo(""), jugador(), ball(), porteria(),
-        jugadores_vistos(), jugadorCerca(),
-        evento("999.0"), evento_anterior("999.0"),
-        lado_campo("l"), flag_kick_off(false) {}
+        : nombre_equipo(""), jugador(), odometria(), ball(), porteria(),
+        jugadores_vistos(), mundo(), jugadorCerca(),
+        evento(), evento_anterior(),
+        lado_campo(Lado::Izquierdo), flag_kick_off(false) {}
 };
 
 #endif // STRUCTS_H
@@ -0,0 +1,232 @@
+/**
+ * @file tabla_flags.h
+ * @brief Tabla constante de flags del campo con hash perfecto por nombre
+ *
+ * Las coordenadas absolutas de los flags se conocen en tiempo de compilación,
+ * así que viven en un array constexpr. Un hash perfecto, también calculado al
+ * compilar, traduce el nombre de un flag ("(f g r b)") a su índice en la tabla
+ * con un solo acceso, sin recorrer la lista ni comparar cadenas una a una.
+ */
+
+#ifndef TABLA_FLAGS_H
+#define TABLA_FLAGS_H
+
+// Inclusión de dependencias
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "structs.h"
+
+using namespace std;
+
+/**
+ * @brief Flags conocidos del campo con sus coordenadas absolutas
+ *
+ * Campo representado como un sistema de coordenadas de 120x80 unidades.
+ *
+ * @note Coordenadas del campo: X: 0-120 (ancho), Y: 0-80 (alto)
+ * @note Centro del campo: (60, 40)
+ */
+constexpr knownFlags TABLA_FLAGS[] = {
+    // ======================================================
+    // PUNTOS CENTRALES Y ESQUINAS PRINCIPALES
+    // ======================================================
+    {"(f c)", 60, 40, DESCONOCIDO, DESCONOCIDO},        // centro del campo
+    {"(f l t)", 8, 74, DESCONOCIDO, DESCONOCIDO},       // esquina superior izquierda
+    {"(f l b)", 8, 6, DESCONOCIDO, DESCONOCIDO},        // esquina inferior izquierda
+    {"(f r t)", 112, 74, DESCONOCIDO, DESCONOCIDO},     // esquina superior derecha
+    {"(f r b)", 112, 6, DESCONOCIDO, DESCONOCIDO},      // esquina inferior derecha
+
+    // ======================================================
+    // PUNTOS DEL ÁREA PENAL
+    // ======================================================
+    {"(f p l t)", 24, 60, DESCONOCIDO, DESCONOCIDO},    // área superior izquierda
+    {"(f p l c)", 24, 40, DESCONOCIDO, DESCONOCIDO},    // área central izquierda
+    {"(f p l b)", 24, 20, DESCONOCIDO, DESCONOCIDO},    // área inferior izquierda
+    {"(f p r t)", 96, 60, DESCONOCIDO, DESCONOCIDO},    // área superior derecha
+    {"(f p r c)", 96, 40, DESCONOCIDO, DESCONOCIDO},    // área central derecha
+    {"(f p r b)", 96, 20, DESCONOCIDO, DESCONOCIDO},    // área inferior derecha
+
+    // ======================================================
+    // PALOS DE PORTERÍA
+    // ======================================================
+    {"(f g l t)", 8, 47, DESCONOCIDO, DESCONOCIDO},     // palo superior izquierdo
+    {"(f g l b)", 8, 33, DESCONOCIDO, DESCONOCIDO},     // palo inferior izquierdo
+    {"(f g r t)", 112, 47, DESCONOCIDO, DESCONOCIDO},   // palo superior derecho
+    {"(f g r b)", 112, 33, DESCONOCIDO, DESCONOCIDO},   // palo inferior derecho
+
+    // ======================================================
+    // BANDA SUPERIOR (FUERA DEL CAMPO)
+    // ======================================================
+    {"(f t l 10)", 50, 80, DESCONOCIDO, DESCONOCIDO},   // banda superior izquierda (-10)
+    {"(f t l 20)", 40, 80, DESCONOCIDO, DESCONOCIDO},   // banda superior izquierda (-20)
+    {"(f t l 30)", 30, 80, DESCONOCIDO, DESCONOCIDO},   // banda superior izquierda (-30)
+    {"(f t l 50)", 10, 80, DESCONOCIDO, DESCONOCIDO},   // banda superior izquierda (-50)
+    {"(f t 0)", 60, 80, DESCONOCIDO, DESCONOCIDO},      // centro banda superior
+    {"(f t r 10)", 70, 80, DESCONOCIDO, DESCONOCIDO},   // banda superior derecha (+10)
+    {"(f t r 20)", 80, 80, DESCONOCIDO, DESCONOCIDO},   // banda superior derecha (+20)
+    {"(f t r 30)", 90, 80, DESCONOCIDO, DESCONOCIDO},   // banda superior derecha (+30)
+    {"(f t r 40)", 100, 80, DESCONOCIDO, DESCONOCIDO},  // banda superior derecha (+40)
+    {"(f t r 50)", 110, 80, DESCONOCIDO, DESCONOCIDO},  // banda superior derecha (+50)
+
+    // ======================================================
+    // BANDA INFERIOR (FUERA DEL CAMPO)
+    // ======================================================
+    {"(f b l 10)", 50, 0, DESCONOCIDO, DESCONOCIDO},    // banda inferior izquierda (-10)
+    {"(f b l 20)", 40, 0, DESCONOCIDO, DESCONOCIDO},    // banda inferior izquierda (-20)
+    {"(f b l 30)", 30, 0, DESCONOCIDO, DESCONOCIDO},    // banda inferior izquierda (-30)
+    {"(f b l 40)", 20, 0, DESCONOCIDO, DESCONOCIDO},    // banda inferior izquierda (-40)
+    {"(f b l 50)", 10, 0, DESCONOCIDO, DESCONOCIDO},    // banda inferior izquierda (-50)
+    {"(f b 0)", 60, 0, DESCONOCIDO, DESCONOCIDO},       // centro banda inferior
+    {"(f b r 10)", 70, 0, DESCONOCIDO, DESCONOCIDO},    // banda inferior derecha (+10)
+    {"(f b r 20)", 80, 0, DESCONOCIDO, DESCONOCIDO},    // banda inferior derecha (+20)
+    {"(f b r 30)", 90, 0, DESCONOCIDO, DESCONOCIDO},    // banda inferior derecha (+30)
+    {"(f b r 40)", 100, 0, DESCONOCIDO, DESCONOCIDO},   // banda inferior derecha (+40)
+    {"(f b r 50)", 110, 0, DESCONOCIDO, DESCONOCIDO},   // banda inferior derecha (+50)
+
+    // ======================================================
+    // LÍNEA DE FONDO IZQUIERDA (FUERA DEL CAMPO)
+    // ======================================================
+    {"(f l t 10)", 0, 50, DESCONOCIDO, DESCONOCIDO},    // fondo izquierdo superior (-10)
+    {"(f l t 20)", 0, 60, DESCONOCIDO, DESCONOCIDO},    // fondo izquierdo superior (-20)
+    {"(f l t 30)", 0, 70, DESCONOCIDO, DESCONOCIDO},    // fondo izquierdo superior (-30)
+    {"(f l b 10)", 0, 30, DESCONOCIDO, DESCONOCIDO},    // fondo izquierdo inferior (-10)
+    {"(f l b 20)", 0, 20, DESCONOCIDO, DESCONOCIDO},    // fondo izquierdo inferior (-20)
+    {"(f l b 30)", 0, 10, DESCONOCIDO, DESCONOCIDO},    // fondo izquierdo inferior (-30)
+
+    // ======================================================
+    // LÍNEA DE FONDO DERECHA (FUERA DEL CAMPO)
+    // ======================================================
+    {"(f r t 10)", 120, 50, DESCONOCIDO, DESCONOCIDO},  // fondo derecho superior (-10)
+    {"(f r t 20)", 120, 60, DESCONOCIDO, DESCONOCIDO},  // fondo derecho superior (-20)
+    {"(f r t 30)", 120, 70, DESCONOCIDO, DESCONOCIDO},  // fondo derecho superior (-30)
+    {"(f r b 10)", 120, 30, DESCONOCIDO, DESCONOCIDO},  // fondo derecho inferior (-10)
+    {"(f r b 20)", 120, 20, DESCONOCIDO, DESCONOCIDO},  // fondo derecho inferior (-20)
+    {"(f r b 30)", 120, 10, DESCONOCIDO, DESCONOCIDO},  // fondo derecho inferior (-30)
+
+    // ======================================================
+    // PUNTOS CENTRALES ADICIONALES
+    // ======================================================
+    {"(f c t)", 60, 74, DESCONOCIDO, DESCONOCIDO},      // centro banda superior
+    {"(f c b)", 60, 6, DESCONOCIDO, DESCONOCIDO},       // centro banda inferior
+    {"(f c r)", 120, 40, DESCONOCIDO, DESCONOCIDO},     // centro línea de fondo derecha
+    {"(f c l)", 0, 40, DESCONOCIDO, DESCONOCIDO},       // centro línea de fondo izquierda
+};
+
+/// Número de flags de la tabla
+constexpr int NUM_FLAGS = static_cast<int>(size(TABLA_FLAGS));
+
+/// Huecos de la tabla hash (potencia de 2, ~5 veces el número de flags)
+constexpr int HUECOS_HASH_FLAGS = 256;
+
+static_assert(NUM_FLAGS < 128, "los índices de flag se guardan en int8_t");
+
+/**
+ * @brief Hash FNV-1a de 32 bits con semilla, reducido a un hueco de la tabla
+ *
+ * @param nombre Nombre completo del flag (ej: "(f g r b)")
+ * @param semilla Semilla que hace el hash perfecto sobre TABLA_FLAGS
+ * @return Hueco en [0, HUECOS_HASH_FLAGS)
+ */
+constexpr uint32_t hash_flag(string_view nombre, uint32_t semilla)
+{
+    uint32_t h = 2166136261u ^ semilla;
+    for (char c : nombre)
+    {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    h ^= h >> 16;
+    return h & (HUECOS_HASH_FLAGS - 1);
+}
+
+/**
+ * @brief Busca la primera semilla sin colisiones entre los nombres de la tabla
+ *
+ * Se evalúa solo en tiempo de compilación.
+ *
+ * @return Semilla del hash perfecto
+ */
+consteval uint32_t buscar_semilla_flags()
+{
+    for (uint32_t semilla = 0;; semilla++)
+    {
+        array<bool, HUECOS_HASH_FLAGS> ocupado{};
+        bool colision = false;
+        for (auto const &f : TABLA_FLAGS)
+        {
+            uint32_t hueco = hash_flag(f.name, semilla);
+            if (ocupado[hueco])
+            {
+                colision = true;
+                break;
+            }
+            ocupado[hueco] = true;
+        }
+        if (!colision)
+            return semilla;
+    }
+}
+
+/// Semilla del hash perfecto, fijada al compilar
+constexpr uint32_t SEMILLA_FLAGS = buscar_semilla_flags();
+
+/**
+ * @brief Construye la tabla hueco -> índice de flag (-1 en huecos vacíos)
+ */
+consteval array<int8_t, HUECOS_HASH_FLAGS> construir_huecos_flags()
+{
+    array<int8_t, HUECOS_HASH_FLAGS> huecos{};
+    huecos.fill(-1);
+    for (int i = 0; i < NUM_FLAGS; i++)
+        huecos[hash_flag(TABLA_FLAGS[i].name, SEMILLA_FLAGS)] = static_cast<int8_t>(i);
+    return huecos;
+}
+
+/// Hueco del hash -> índice en TABLA_FLAGS
+constexpr array<int8_t, HUECOS_HASH_FLAGS> HUECOS_FLAGS = construir_huecos_flags();
+
+/**
+ * @brief Traduce el nombre de un flag a su índice en TABLA_FLAGS
+ *
+ * Un hash y una comparación: los nombres que no son flags conocidos (por
+ * ejemplo flags de versiones de protocolo que no están en la tabla) caen en
+ * un hueco vacío o no coinciden con el nombre guardado.
+ *
+ * @param nombre Nombre completo del flag (ej: "(f g r b)")
+ * @return Índice en TABLA_FLAGS, o -1 si no es un flag conocido
+ */
+constexpr int indice_flag(string_view nombre)
+{
+    int i = HUECOS_FLAGS[hash_flag(nombre, SEMILLA_FLAGS)];
+    return (i >= 0 && TABLA_FLAGS[i].name == nombre) ? i : -1;
+}
+
+static_assert(indice_flag("(f c)") == 0, "el centro es el primer flag");
+static_assert(indice_flag("(f g r b)") >= 0 && indice_flag("(g r)") == -1 && indice_flag("(f x)") == -1,
+              "el hash perfecto debe distinguir flags conocidos del resto");
+
+/**
+ * @brief Medidas de un ciclo sobre todos los flags del campo
+ *
+ * Los flags se guardan por valor en el orden de TABLA_FLAGS, de modo que el
+ * índice que da indice_flag() sirve directamente para actualizarlos. Los
+ * índices de los flags vistos en el último "see" se guardan aparte, así que
+ * borrar las medidas anteriores y recorrer las actuales cuesta lo que el
+ * número de flags visibles, no lo que la tabla entera.
+ */
+struct FlagsCampo
+{
+    array<knownFlags, NUM_FLAGS> flags;   ///< Coordenadas y medidas, en el orden de TABLA_FLAGS
+    array<uint8_t, NUM_FLAGS> visibles;   ///< Índices de los flags vistos en el último "see", en orden del mensaje
+    int num_visibles;                     ///< Entradas válidas en visibles
+
+    /**
+     * @brief Flag k-ésimo de los vistos en el último "see"
+     */
+    knownFlags const &visible(int k) const { return flags[visibles[k]]; }
+};
+
+#endif // TABLA_FLAGS_H
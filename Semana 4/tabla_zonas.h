@@ -0,0 +1,124 @@
+/**
+ * @file tabla_zonas.h
+ * @brief Zonas de responsabilidad de cada dorsal como mapa de bits constexpr
+ *
+ * Las zonas de la formación se describen como rectángulos para el lado
+ * izquierdo. Al compilar se rasterizan en una rejilla de celdas de 1 m sobre
+ * el campo de 120x80, un mapa de bits por dorsal. Comprobar si un jugador
+ * está en su zona es calcular su celda y leer un bit; el lado derecho usa la
+ * misma tabla con la posición reflejada respecto al centro del campo.
+ */
+
+#ifndef TABLA_ZONAS_H
+#define TABLA_ZONAS_H
+
+// Inclusión de dependencias
+#include <array>
+#include <cstdint>
+
+#include "structs.h"
+
+using namespace std;
+
+/**
+ * @brief Rectángulo de la zona de un dorsal (lado izquierdo, ataca hacia la derecha)
+ *
+ * Cubre x en [x_min, x_max) e y en [y_min, y_max), en metros enteros. Un
+ * dorsal puede tener varios rectángulos: su zona es la unión.
+ */
+struct ZonaRol
+{
+    int dorsal;   ///< Dorsal 1-11
+    int x_min;    ///< Límite inferior en X
+    int x_max;    ///< Límite superior en X
+    int y_min;    ///< Límite inferior en Y
+    int y_max;    ///< Límite superior en Y
+};
+
+/**
+ * @brief Zonas de la formación 4-3-3 para el lado izquierdo
+ *
+ * @note Coordenadas del campo: X: 0-120 (ancho), Y: 0-80 (alto)
+ * @note Para cambiar de formación basta con editar esta tabla
+ */
+constexpr ZonaRol TABLA_ZONAS[] = {
+    {1, 8, 18, 33, 47},     // portero: área de meta
+    {2, 8, 40, 40, 74},     // lateral derecho: banda defensiva
+    {3, 8, 35, 30, 60},     // central derecho
+    {4, 8, 35, 20, 50},     // central izquierdo
+    {5, 8, 40, 8, 40},      // lateral izquierdo: banda defensiva
+    {6, 30, 80, 40, 60},    // mediocentro derecho
+    {7, 30, 80, 20, 40},    // mediocentro central
+    {8, 30, 80, 20, 60},    // mediocentro izquierdo (zona más amplia)
+    {9, 45, 112, 8, 74},    // delantero derecho
+    {10, 45, 112, 6, 74},   // delantero centro
+    {11, 45, 112, 6, 74},   // delantero izquierdo
+};
+
+/// Celdas de 1 m a lo ancho (X) y a lo alto (Y) del campo
+constexpr int CELDAS_X_ZONAS = 120;
+constexpr int CELDAS_Y_ZONAS = 80;
+
+/// Palabras de 64 bits del mapa de un dorsal
+constexpr int PALABRAS_ZONA = (CELDAS_X_ZONAS * CELDAS_Y_ZONAS + 63) / 64;
+
+/// Dorsales con zona (1-11)
+constexpr int NUM_ROLES_ZONAS = 11;
+
+/**
+ * @brief Rasteriza TABLA_ZONAS en un mapa de bits por dorsal
+ *
+ * El bit de la celda (columna, fila) del dorsal d está en la posición
+ * fila * CELDAS_X_ZONAS + columna del bloque de PALABRAS_ZONA palabras de d.
+ * Se evalúa solo en tiempo de compilación.
+ */
+consteval array<uint64_t, NUM_ROLES_ZONAS * PALABRAS_ZONA> construir_mapa_zonas()
+{
+    array<uint64_t, NUM_ROLES_ZONAS * PALABRAS_ZONA> mapa{};
+    for (auto const &z : TABLA_ZONAS)
+        for (int fila = z.y_min; fila < z.y_max; fila++)
+            for (int columna = z.x_min; columna < z.x_max; columna++)
+            {
+                int bit = fila * CELDAS_X_ZONAS + columna;
+                mapa[(z.dorsal - 1) * PALABRAS_ZONA + (bit >> 6)] |= uint64_t{1} << (bit & 63);
+            }
+    return mapa;
+}
+
+/// Mapa de bits de las zonas, fijado al compilar
+constexpr array<uint64_t, NUM_ROLES_ZONAS * PALABRAS_ZONA> MAPA_ZONAS = construir_mapa_zonas();
+
+/**
+ * @brief Indica si una posición está en la zona de un dorsal
+ *
+ * En el lado derecho la posición se refleja (x -> 120 - x, y -> 80 - y) y se
+ * consulta la misma tabla. Posiciones fuera del campo, desconocidas o con un
+ * dorsal o lado no válidos no están en ninguna zona.
+ *
+ * @param dorsal Dorsal del jugador
+ * @param lado Lado en el que juega su equipo
+ * @param x Coordenada X absoluta
+ * @param y Coordenada Y absoluta
+ */
+constexpr bool en_zona(int dorsal, Lado lado, float x, float y)
+{
+    if (dorsal < 1 || dorsal > NUM_ROLES_ZONAS || lado == Lado::Desconocido)
+        return false;
+    if (lado == Lado::Derecho)
+    {
+        x = CELDAS_X_ZONAS - x;
+        y = CELDAS_Y_ZONAS - y;
+    }
+    // Comparación negada para que también descarte NaN
+    if (!(x >= 0 && x < CELDAS_X_ZONAS && y >= 0 && y < CELDAS_Y_ZONAS))
+        return false;
+    int bit = static_cast<int>(y) * CELDAS_X_ZONAS + static_cast<int>(x);
+    return (MAPA_ZONAS[(dorsal - 1) * PALABRAS_ZONA + (bit >> 6)] >> (bit & 63)) & 1;
+}
+
+static_assert(en_zona(1, Lado::Izquierdo, 10, 40) && !en_zona(1, Lado::Izquierdo, 30, 40),
+              "el portero izquierdo defiende su área de meta");
+static_assert(en_zona(1, Lado::Derecho, 110, 40) && !en_zona(1, Lado::Izquierdo, 110, 40),
+              "el lado derecho es el reflejo del izquierdo");
+
+#endif // TABLA_ZONAS_H
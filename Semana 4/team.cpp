@@ -0,0 +1,132 @@
+/**
+ * @file team.cpp
+ * @brief Programa principal del equipo completo en un único proceso
+ *
+ * Abre los 11 sockets UDP de los jugadores en el mismo proceso y los
+ * multiplexa sobre un único epoll. Cada datagrama recibido ejecuta el paso
+ * percepción-decisión-acción del agente correspondiente, sin hilos ni
+ * procesos adicionales. Los temporizadores de envío de cada jugador se
+ * atienden en el mismo epoll.
+ */
+
+#include <csignal>
+#include <iostream>
+#include <vector>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "agente.h"
+#include "numeros.h"
+
+/// Número de jugadores que aloja el proceso
+constexpr int NUM_JUGADORES = 11;
+
+/// Se activa con SIGINT/SIGTERM para salir del bucle de eventos
+static volatile sig_atomic_t fin_solicitado = 0;
+
+static void terminar(int)
+{
+    fin_solicitado = 1;
+}
+
+int main(int argc, char *argv[])
+{
+    // Verificación de argumentos de línea de comandos
+    if (argc < 2 || argc > 4)
+    {
+        cout << "Uso: " << argv[0] << " <nombre-equipo> [puerto-base] [ip-servidor]" << endl;
+        return 1;
+    }
+
+    string nombre_equipo = argv[1];
+    int puerto_base = 9000;
+    if (argc >= 3 && (leer_entero(argv[2], puerto_base) != ErrorNumero::Ninguno || puerto_base <= 0 || puerto_base > 65535 - 11))
+    {
+        cout << "Puerto base no válido: " << argv[2] << endl;
+        return 1;
+    }
+    string host = (argc == 4) ? argv[3] : "127.0.0.1";
+
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0)
+    {
+        cout << "Error al crear epoll" << endl;
+        return 1;
+    }
+
+    // ======================================================
+    // APERTURA DE LOS 11 SOCKETS Y REGISTRO EN EPOLL
+    // ======================================================
+    vector<Agente> agentes(NUM_JUGADORES);
+    for (int i = 0; i < NUM_JUGADORES; i++)
+    {
+        // Mismos puertos que run_my_team.sh (base + número de jugador)
+        uint16_t puerto = static_cast<uint16_t>(puerto_base + i + 1);
+        if (!abrir_agente(agentes[i], nombre_equipo, puerto, host, 6000))
+        {
+            cout << "Error al abrir el socket del puerto " << puerto << endl;
+            return 1;
+        }
+        activar_grabacion(agentes[i], puerto);
+
+        // Cada jugador registra su socket y su temporizador de envío;
+        // el bit bajo del identificador distingue uno de otro
+        epoll_event evento{};
+        evento.events = EPOLLIN;
+        evento.data.u32 = static_cast<uint32_t>(i << 1);
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, agentes[i].socket_fd, &evento);
+        evento.data.u32 = static_cast<uint32_t>((i << 1) | 1);
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, agentes[i].temporizador_fd, &evento);
+    }
+
+    // El servidor asigna los dorsales por orden de llegada del init
+    for (auto &agente : agentes)
+        enviar_init(agente);
+    cout << "Equipo " << nombre_equipo << ": " << NUM_JUGADORES << " jugadores conectando" << endl;
+
+    // ======================================================
+    // BUCLE DE EVENTOS
+    // ======================================================
+    epoll_event eventos[2 * NUM_JUGADORES];
+
+    signal(SIGINT, terminar);
+    signal(SIGTERM, terminar);
+
+    while (!fin_solicitado)
+    {
+        int listos = epoll_wait(epoll_fd, eventos, 2 * NUM_JUGADORES, -1);
+        for (int e = 0; e < listos; e++)
+        {
+            Agente &agente = agentes[eventos[e].data.u32 >> 1];
+
+            // Temporizador vencido: el comando sale en el último instante seguro del ciclo
+            if (eventos[e].data.u32 & 1)
+            {
+                despachar_pendiente(agente);
+                continue;
+            }
+
+            // Vaciamos el socket: el "see" más reciente decide el comando pendiente
+            if (ingerir_pendientes(agente))
+                actuar(agente);
+        }
+    }
+
+    // Resumen de la ingesta por jugador
+    for (auto &agente : agentes)
+    {
+        if (agente.inicializado)
+            cout << "Jugador " << agente.datos.jugador.jugador_numero
+                 << ": datagramas " << agente.ingesta.datagramas
+                 << ", lotes " << agente.ingesta.lotes
+                 << ", see procesados " << agente.ingesta.see_procesados
+                 << ", see descartados " << agente.ingesta.see_descartados
+                 << ", ciclos " << agente.reloj.ciclos
+                 << ", comandos " << agente.reloj.comandos_enviados
+                 << ", tardios " << agente.reloj.comandos_tardios
+                 << ", ciclos sin comando " << agente.reloj.ciclos_sin_comando << endl;
+        cerrar_agente(agente);
+    }
+    close(epoll_fd);
+    return 0;
+}
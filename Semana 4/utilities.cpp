@@ -1,83 +1,342 @@
 #include "utilities.h"
 
+#include <bit>
+#include <cstdlib>
+#include <cstring>
 #include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define ESCANER_X86 1
+#else
+#define ESCANER_X86 0
+#endif
              using namespace std;
 
-vector <string> separate_string(string const &str)
+// ======================================================
+// ESCÁNER ESTRUCTURAL (ETAPA 1)
+// ======================================================
+
+/// Máscaras de un bloque de 64 bytes: bit j = byte j del bloque
+struct MascarasBloque
+{
+    uint64_t abre;          ///< '('
+    uint64_t cierra;        ///< ')'
+    uint64_t comillas;      ///< '"'
+    uint64_t separadores;   ///< ' ', '\t', '\n', '\r', '\0'
+};
+
+/// Estado que pasa de un bloque al siguiente
+struct EstadoEscaner
+{
+    uint64_t en_comillas = 0;   ///< Todo unos si el bloque anterior terminó dentro de comillas
+    uint64_t atomo_previo = 0;  ///< 1 si el último byte del bloque anterior era de un átomo
+};
+
+static MascarasBloque clasificar_escalar(const char *bloque)
 {
-    vector <string> resultado;
-    int num_abierto{0};
-    bool flag_abierto{0};
-    int num_cerrado{0};
-    int abierto_inicio;
-    for (int i = 0; i < str.size(); i++)
+    MascarasBloque m{0, 0, 0, 0};
+    for (int j = 0; j < 64; j++)
     {
-        if (str.at(i) == '(')
-        {
-            flag_abierto = 1;
-            num_abierto++;
-            if (num_abierto == 1)
-            {
-                abierto_inicio = i;
-            }
-        }
-        if (str.at(i) == ')')
+        uint64_t bit = uint64_t{1} << j;
+        switch (bloque[j])
         {
-            if(flag_abierto == 1 && num_abierto == 1)
-            {
-                num_abierto = 0;
-                flag_abierto = 0;
-                resultado.push_back(str.substr(abierto_inicio + 1, i - abierto_inicio - 1));
-            }
-            num_cerrado++;
-            if ((num_abierto - num_cerrado) == 0)
-            {
-                num_abierto = 0;
-                num_cerrado = 0;
-                resultado.push_back(str.substr(abierto_inicio + 1, i - abierto_inicio - 1));
-            }
+        case '(': m.abre |= bit; break;
+        case ')': m.cierra |= bit; break;
+        case '"': m.comillas |= bit; break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case '\0': m.separadores |= bit; break;
+        default: break;
         }
     }
-    return (resultado);
+    return m;
+}
+
+#if ESCANER_X86
+static MascarasBloque clasificar_sse2(const char *bloque)
+{
+    MascarasBloque m{0, 0, 0, 0};
+    for (int j = 0; j < 64; j += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bloque + j));
+        auto mascara = [](__m128i x) { return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(x))); };
+        __m128i separador = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))),
+                         _mm_cmpeq_epi8(v, _mm_setzero_si128())));
+        m.abre |= mascara(_mm_cmpeq_epi8(v, _mm_set1_epi8('('))) << j;
+        m.cierra |= mascara(_mm_cmpeq_epi8(v, _mm_set1_epi8(')'))) << j;
+        m.comillas |= mascara(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << j;
+        m.separadores |= mascara(separador) << j;
+    }
+    return m;
 }
 
+[[gnu::target("avx2")]] static inline uint64_t mascara_avx2(__m256i x)
+{
+    return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(x)));
+}
 
-vector <string> separate_string_separator(string const &str, char separador)
+[[gnu::target("avx2")]] static MascarasBloque clasificar_avx2(const char *bloque)
 {
-    vector <string> resultado;
-    string temp{""};
-    bool flag_palabra{0};
-    for (int i{0}; i < str.size(); i++)
+    MascarasBloque m{0, 0, 0, 0};
+    for (int j = 0; j < 64; j += 32)
     {
-        if (str.at(i) == separador)
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bloque + j));
+        __m256i separador = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))),
+                            _mm256_cmpeq_epi8(v, _mm256_setzero_si256())));
+        m.abre |= mascara_avx2(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('('))) << j;
+        m.cierra |= mascara_avx2(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(')'))) << j;
+        m.comillas |= mascara_avx2(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))) << j;
+        m.separadores |= mascara_avx2(separador) << j;
+    }
+    return m;
+}
+#endif
+
+/**
+ * @brief XOR prefijo: el bit j es el XOR de los bits 0..j (marca el interior de las comillas)
+ */
+static inline uint64_t prefijo_xor(uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/**
+ * @brief Convierte las máscaras de un bloque en índices estructurales
+ *
+ * Común a todas las implementaciones: solo cambia cómo se obtienen las máscaras.
+ *
+ * @param m Máscaras del bloque
+ * @param validos Bytes del bloque que pertenecen al mensaje
+ * @param estado Estado arrastrado entre bloques
+ * @param base Posición del primer byte del bloque en el mensaje
+ * @param salida Siguiente hueco libre de la salida
+ * @return Hueco libre tras escribir los índices del bloque
+ */
+static inline uint32_t *procesar_bloque(MascarasBloque const &m, uint64_t validos, EstadoEscaner &estado, uint32_t base,
+                                        uint32_t *salida)
+{
+    // Interior de las comillas, incluidas las dos comillas
+    uint64_t interior = prefijo_xor(m.comillas) ^ estado.en_comillas;
+    estado.en_comillas = static_cast<uint64_t>(static_cast<int64_t>(interior) >> 63);
+    uint64_t entre_comillas = interior | m.comillas;
+
+    uint64_t parentesis = (m.abre | m.cierra) & ~entre_comillas;
+    uint64_t atomo = ~(parentesis | (m.separadores & ~entre_comillas)) & validos;
+    uint64_t previo = (atomo << 1) | estado.atomo_previo;
+    estado.atomo_previo = atomo >> 63;
+
+    // Los bytes fuera del mensaje no son de átomo: el fin de un átomo final cae en mensaje.size()
+    uint64_t estructural = parentesis | (atomo & ~previo) | (~atomo & previo);
+    while (estructural != 0)
+    {
+        *salida++ = base + static_cast<uint32_t>(countr_zero(estructural));
+        estructural &= estructural - 1;
+    }
+    return salida;
+}
+
+/**
+ * @brief Recorre el mensaje en bloques de 64 bytes con el clasificador dado
+ *
+ * Se inserta en cada variante para que el clasificador SIMD quede en línea
+ * dentro de una función compilada para su juego de instrucciones.
+ */
+template <MascarasBloque (*Clasificar)(const char *)>
+[[gnu::always_inline]] static inline void escanear_con(string_view mensaje, vector<uint32_t> &indices)
+{
+    // Como mucho un índice por byte más el fin del último átomo: se escribe sin comprobar capacidad
+    const char *datos = mensaje.data();
+    size_t n = mensaje.size();
+    indices.resize(n + 1);
+    uint32_t *salida = indices.data();
+    EstadoEscaner estado;
+
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+        salida = procesar_bloque(Clasificar(datos + i), ~uint64_t{0}, estado, static_cast<uint32_t>(i), salida);
+
+    if (i < n)
+    {
+        // Último bloque parcial, completado con separadores
+        char resto[64];
+        memset(resto, ' ', sizeof(resto));
+        memcpy(resto, datos + i, n - i);
+        salida = procesar_bloque(Clasificar(resto), (uint64_t{1} << (n - i)) - 1, estado, static_cast<uint32_t>(i), salida);
+    }
+    else if (estado.atomo_previo)
+        *salida++ = static_cast<uint32_t>(n);
+    indices.resize(static_cast<size_t>(salida - indices.data()));
+}
+
+static void escanear_escalar(string_view mensaje, vector<uint32_t> &indices)
+{
+    escanear_con<clasificar_escalar>(mensaje, indices);
+}
+
+#if ESCANER_X86
+static void escanear_sse2(string_view mensaje, vector<uint32_t> &indices)
+{
+    escanear_con<clasificar_sse2>(mensaje, indices);
+}
+
+[[gnu::target("avx2")]] static void escanear_avx2(string_view mensaje, vector<uint32_t> &indices)
+{
+    escanear_con<clasificar_avx2>(mensaje, indices);
+}
+#endif
+
+/**
+ * @brief Elige la mejor implementación que admite la CPU, salvo que RCSS_SIMD fuerce otra
+ */
+static NivelSimd detectar_nivel()
+{
+    NivelSimd nivel = NivelSimd::Escalar;
+#if ESCANER_X86
+    nivel = __builtin_cpu_supports("avx2") ? NivelSimd::Avx2 : NivelSimd::Sse2;
+#endif
+    if (const char *forzado = getenv("RCSS_SIMD"))
+    {
+        string_view pedido = forzado;
+        if (pedido == "escalar")
+            nivel = NivelSimd::Escalar;
+        else if (pedido == "sse2" && nivel == NivelSimd::Avx2)
+            nivel = NivelSimd::Sse2;
+    }
+    return nivel;
+}
+
+NivelSimd nivel_escaner()
+{
+    static const NivelSimd nivel = detectar_nivel();
+    return nivel;
+}
+
+const char *nombre_nivel_simd(NivelSimd nivel)
+{
+    switch (nivel)
+    {
+    case NivelSimd::Sse2: return "sse2";
+    case NivelSimd::Avx2: return "avx2";
+    default: return "escalar";
+    }
+}
+
+void escanear_estructura(string_view mensaje, vector<uint32_t> &indices)
+{
+    using Escaner = void (*)(string_view, vector<uint32_t> &);
+    static const Escaner escaner = []() -> Escaner
+    {
+#if ESCANER_X86
+        if (nivel_escaner() == NivelSimd::Avx2)
+            return escanear_avx2;
+        if (nivel_escaner() == NivelSimd::Sse2)
+            return escanear_sse2;
+#endif
+        return escanear_escalar;
+    }();
+    escaner(mensaje, indices);
+}
+
+// ======================================================
+// CONSTRUCCIÓN DEL ÁRBOL (ETAPA 2)
+// ======================================================
+
+/**
+ * @brief Añade un nodo como último hijo de la lista abierta actual
+ */
+static int anadir_nodo(ArbolSexp &arbol, int padre, int ultimo[], int profundidad, string_view texto, bool es_lista)
+{
+    int indice = static_cast<int>(arbol.nodos.size());
+    arbol.nodos.push_back({texto, padre, -1, -1, 0, es_lista});
+
+    if (ultimo[profundidad] != -1)
+        arbol.nodos[ultimo[profundidad]].siguiente = indice;
+    else if (padre != -1)
+        arbol.nodos[padre].primer_hijo = indice;
+    if (padre != -1)
+        arbol.nodos[padre].num_hijos++;
+    ultimo[profundidad] = indice;
+    return indice;
+}
+
+bool tokenizar(string_view mensaje, ArbolSexp &arbol)
+{
+    arbol.nodos.clear();
+    escanear_estructura(mensaje, arbol.estructura);
+
+    // Último hijo añadido en cada nivel, para enlazar hermanos sin buscar
+    int ultimo[PROFUNDIDAD_MAX_SEXP + 1];
+    ultimo[0] = -1;
+    int profundidad = 0;
+    int abierta = -1;
+
+    const char *datos = mensaje.data();
+    size_t n = mensaje.size();
+    vector<uint32_t> const &indices = arbol.estructura;
+    size_t total = indices.size();
+    size_t k = 0;
+    while (k < total)
+    {
+        size_t i = indices[k];
+        char c = datos[i];
+        if (c == '(')
         {
-            if (flag_palabra == 1)
-            {
-                resultado.push_back(temp);
-                temp = "";
-            }
-            flag_palabra = 1;
+            if (profundidad == PROFUNDIDAD_MAX_SEXP)
+                return false;
+            abierta = anadir_nodo(arbol, abierta, ultimo, profundidad, string_view(datos + i, 1), true);
+            ultimo[++profundidad] = -1;
+            k++;
         }
-        else if (flag_palabra = 1)
+        else if (c == ')')
         {
-            temp = temp + str.at(i);
+            if (profundidad == 0)
+                return false;
+            NodoSexp &lista = arbol.nodos[abierta];
+            lista.texto = string_view(lista.texto.data(), static_cast<size_t>(datos + i + 1 - lista.texto.data()));
+            abierta = lista.padre;
+            profundidad--;
+            k++;
+        }
+        else
+        {
+            // Átomo: acaba en el índice siguiente. Si ahí hay un paréntesis se
+            // procesa en la próxima vuelta; un separador o el final se saltan.
+            if (k + 1 >= total)
+                return false;
+            size_t fin = indices[k + 1];
+            anadir_nodo(arbol, abierta, ultimo, profundidad, string_view(datos + i, fin - i), false);
+            k += (fin < n && (datos[fin] == '(' || datos[fin] == ')')) ? 1 : 2;
         }
     }
-    if (temp != "")
-        resultado.push_back(temp);
-    return (resultado);
+    return profundidad == 0 && !arbol.nodos.empty();
 }
 
-string vector_separar_string(string const &linea)
+int hijo(ArbolSexp const &arbol, int nodo, int k)
 {
-    int i{0};
-    int valor{0};
-    while (i < linea.size())
-    {
-        if (linea.at(i) == ')')
-            valor = i;
-        i++;
-    }
-    string nueva_linea = linea.substr(valor + 1, linea.size() - valor);
-    return (nueva_linea);
+    if (nodo < 0 || nodo >= static_cast<int>(arbol.nodos.size()))
+        return -1;
+    int h = arbol.nodos[nodo].primer_hijo;
+    while (h != -1 && k-- > 0)
+        h = arbol.nodos[h].siguiente;
+    return h;
+}
+
+string_view texto_hijo(ArbolSexp const &arbol, int nodo, int k)
+{
+    int h = hijo(arbol, nodo, k);
+    return (h == -1) ? string_view() : arbol.nodos[h].texto;
 }
@@ -4,66 +4,127 @@
  *
  * Este módulo proporciona funciones auxiliares para manipulación y procesamiento
  * de strings, especialmente útiles para parsear mensajes del protocolo del simulador.
- * Incluye funciones para dividir cadenas, manejar paréntesis y procesar tokens.
+ * Incluye un tokenizador de S-expressions que trabaja sobre vistas sin copiar texto.
  */
 
 #ifndef UTILS_H
 #define UTILS_H
 
 // Inclusión de dependencias
+#include <cstdint>
 #include <iostream>
 #include <string>    // Para manipulación de cadenas
+#include <string_view> // Vistas sin copia sobre el buffer de recepción
 #include <vector>    // Para contenedores dinámicos de strings
 
 using namespace std;
 
+/// Profundidad máxima de anidación admitida (un see usa 3 niveles)
+constexpr int PROFUNDIDAD_MAX_SEXP = 32;
+
 /**
- * @brief Divide una cadena en subcadenas usando un separador específico
+ * @brief Nodo de una S-expression: un átomo o una lista entre paréntesis
  *
- * Similar a la función split() de otros lenguajes, divide un string en tokens
- * basándose en un carácter delimitador. Útil para procesar mensajes con
- * formato delimitado por espacios, comas u otros caracteres.
+ * Los textos son vistas sobre el mensaje original, que debe seguir vivo
+ * mientras se use el árbol.
+ */
+struct NodoSexp
+{
+    string_view texto;  ///< Átomo, o la lista completa con sus paréntesis ("(f c)")
+    int padre;          ///< Índice del padre (-1 en el nivel superior)
+    int primer_hijo;    ///< Índice del primer hijo (-1 si no tiene)
+    int siguiente;      ///< Índice del siguiente hermano (-1 si es el último)
+    int num_hijos;      ///< Número de hijos directos
+    bool es_lista;      ///< true si el nodo es una lista
+};
+
+/**
+ * @brief Árbol plano de una S-expression
  *
- * @param str Cadena de entrada a dividir
- * @param separador Carácter delimitador para la división (ej: ' ', ',', ';')
- * @return Vector de strings conteniendo los tokens resultantes
+ * Los nodos se guardan en orden de aparición; el nodo 0 es la primera
+ * expresión del mensaje. Los vectores se reutilizan entre mensajes, de modo
+ * que tras el primer mensaje tokenizar no reserva memoria.
+ */
+struct ArbolSexp
+{
+    vector<NodoSexp> nodos;
+    vector<uint32_t> estructura;    ///< Índices estructurales del último mensaje (ver escanear_estructura)
+};
+
+/// Implementación del escáner estructural elegida en tiempo de ejecución
+enum class NivelSimd : uint8_t
+{
+    Escalar,    ///< Byte a byte (cualquier arquitectura)
+    Sse2,       ///< 16 bytes por comparación (x86-64)
+    Avx2        ///< 32 bytes por comparación (x86-64 con AVX2)
+};
+
+/**
+ * @brief Índice estructural de un mensaje, al estilo de la etapa 1 de simdjson
  *
- * @example
- * split("hola mundo ejemplo", ' ') -> {"hola", "mundo", "ejemplo"}
- * split("10,20,30", ',') -> {"10", "20", "30"}
+ * Clasifica el mensaje en bloques de 64 bytes con máscaras de bits de '(',
+ * ')', '"' y separadores (espacio, tabulador, fin de línea y '\0'). Las
+ * comillas se emparejan con un XOR prefijo, de modo que todo lo que va entre
+ * comillas cuenta como parte de un átomo. Devuelve, en orden, la posición de:
+ *  - cada paréntesis fuera de comillas,
+ *  - el primer byte de cada átomo,
+ *  - el byte que cierra cada átomo (separador, paréntesis o mensaje.size()).
+ *
+ * Un paréntesis que cierra un átomo aparece una sola vez.
+ *
+ * @param mensaje Mensaje del servidor
+ * @param indices Salida (se vacía antes de rellenarla)
  */
-vector<string> separate_string_separator(string const &str, char separador);
+void escanear_estructura(string_view mensaje, vector<uint32_t> &indices);
 
 /**
- * @brief Procesa una cadena con estructura de paréntesis anidados
+ * @brief Implementación del escáner en uso
  *
- * Extrae bloques de texto delimitados por paréntesis, respetando la anidación.
- * Esencial para procesar mensajes S-expressions del simulador RCSS,
- * que utilizan paréntesis para estructurar información jerárquica.
+ * Por defecto la mejor que admite la CPU; la variable de entorno RCSS_SIMD
+ * ("escalar" o "sse2") fuerza una inferior para comparar.
+ */
+NivelSimd nivel_escaner();
+
+/**
+ * @brief Nombre legible de un nivel del escáner ("escalar", "sse2", "avx2")
+ */
+const char *nombre_nivel_simd(NivelSimd nivel);
+
+/**
+ * @brief Tokeniza un mensaje S-expression sin copiar texto
  *
- * @param str Cadena con paréntesis anidados (ej: "(see (b) (g l))")
- * @return Vector de strings con los bloques extraídos, sin los paréntesis externos
+ * Primero obtiene el índice estructural con escanear_estructura() y después
+ * construye el árbol saltando de índice en índice, sin volver a mirar los
+ * bytes de dentro de los átomos.
+ *
+ * Los átomos se separan por espacios y paréntesis; las cadenas entre comillas
+ * ("Equipo") forman parte de un único átomo aunque contengan espacios o
+ * paréntesis.
+ *
+ * @param mensaje Mensaje del servidor (ej: "(see 12 ((b) 10 -3) ((f c) 20 5))")
+ * @param arbol Árbol de salida (se vacía antes de rellenarlo)
+ * @return false si los paréntesis no están equilibrados o se supera la profundidad
  *
  * @example
- * GestionParentesis("(see (b) (g l))") -> {"see", "(b)", "(g l)"}
- * GestionParentesis("((a b) (c d) (e f))") -> {"a b", "c d", "e f"}
+ * tokenizar("(init l 2 before_kick_off)") -> lista con átomos {"init", "l", "2", "before_kick_off"}
  */
-vector<string> separate_string(string const &str);
+bool tokenizar(string_view mensaje, ArbolSexp &arbol);
 
 /**
- * @brief Procesa una línea de datos para extraer valores individuales
+ * @brief Índice del hijo k-ésimo de un nodo
  *
- * Función especializada para procesar líneas del simulador que contienen
- * múltiples valores numéricos y simbólicos. Maneja formatos mixtos
- * que incluyen paréntesis, números y palabras clave.
+ * @return Índice del hijo o -1 si no existe
+ */
+int hijo(ArbolSexp const &arbol, int nodo, int k);
+
+/**
+ * @brief Texto del hijo k-ésimo de un nodo
  *
- * @param linea Cadena con múltiples valores (ej: "(b) 12.5 45.3")
- * @return String procesado o primer token extraído
+ * @return Texto del hijo o vista vacía si no existe
  *
  * @example
- * vector_separar_string("(b) 12.5 45.3") -> "b"
- * vector_separar_string("(g l) 30.2 15.8") -> "g l"
+ * texto_hijo(arbol, 0, 0) sobre "(hear 0 referee kick_off_l)" -> "hear"
  */
-string vector_separar_string(string const &linea);
+string_view texto_hijo(ArbolSexp const &arbol, int nodo, int k);
 
 #endif // UTILS_H